@@ -9,6 +9,7 @@
 #include "Collection.h"
 #include "Utility.h"
 #include <fstream>
+#include <vector>
 using namespace std;
 
 /* Construct a Collection from an input file stream in save format,
@@ -17,27 +18,30 @@ using namespace std;
  No check made for whether the Collection already exists or not.
  Throw Error exception if invalid data discovered in file.
  String data input is read directly into the member variable. */
-Collection::Collection(ifstream& is, const Ordered_list<Record*,
+Collection::Collection(ifstream& is, const Ordered_container<Record*,
                        Less_than_ptr<Record*>>& library) {
   int num_records = 0;
   if (!(is >> name >> num_records)) {
     throw_file_exception();
   }
+  // the members were saved in title order, so they are collected in a vector
+  // and then merged into the list in a single pass
+  vector<Record*> member_ptrs;
   for (int i = 0; i < num_records; i++) {
     // sucks out '\n' after num_records, proceed to read next line below
     while (is.get() != '\n');
     String title;
     getline(is, title);
-    Record record(title);
-    // container of pointers to rec
-    auto it = library.find(&record);
+    // the title itself is the key, so no probe Record is needed
+    auto it = library.find(title);
     // check that title must exist in library
     if (it == library.end()) {
       throw_file_exception();
     }
     // add the pointer
-    list_of_record_ptrs.insert(*it);
+    member_ptrs.push_back(*it);
   } // for
+  list_of_record_ptrs.insert_sorted_range(member_ptrs.begin(), member_ptrs.end());
 }
 
 // Add the Record, throw exception if there is already a Record with the same title.
@@ -10,8 +10,15 @@
 #define COLLECTION_H
 #include "String.h"
 #include "Ordered_list.h"
+#include "Unrolled_ordered_list.h"
 #include "Record.h"
 
+// The ordered container used for the members of a Collection, and for the
+// libraries and catalog in p2_main. Change Ordered_list to Unrolled_ordered_list
+// here to keep the items in cache-line-sized chunks instead of one per node.
+template<typename T, typename OF>
+using Ordered_container = Ordered_list<T, OF>;
+
 class Collection {
   /* Collections contain a name and a container of members, represented as 
    pointers to Records. Collection objects manage their own Record container.
@@ -27,7 +34,7 @@ public:
    references to record members. No check made for whether the Collection already 
    exists or not. Throw Error exception if invalid data discovered in file.
    String data input is read directly into the member variable. */
-  Collection(std::ifstream& is, const Ordered_list<Record*,
+  Collection(std::ifstream& is, const Ordered_container<Record*,
              Less_than_ptr<Record*>>& library);
   
   // Accessors
@@ -53,13 +60,19 @@ public:
   // This operator defines the order relation between Collections, based just on the name
   bool operator< (const Collection& rhs) const
 		{return name < rhs.name;}
+  // These compare a Collection with a name, so that a name can be used directly
+  // as the key to find a Collection in a container ordered by name.
+  friend bool operator< (const Collection& lhs, const String& rhs_name)
+		{return lhs.name < rhs_name;}
+  friend bool operator< (const String& lhs_name, const Collection& rhs)
+		{return lhs_name < rhs.name;}
   
   /* *** fill in a friend declaration for the output operator */
   friend std::ostream& operator<< (std::ostream& os, const Collection& collection);
 		
 private:
   /* *** the member information must be kept in a container of Record* - name is your choice */
-	 Ordered_list<Record*, Less_than_ptr<Record*>> list_of_record_ptrs;
+	 Ordered_container<Record*, Less_than_ptr<Record*>> list_of_record_ptrs;
     /* *** other private members are your choice */
   String name;
 };
@@ -0,0 +1,102 @@
+//
+//  Instrumentation.cpp
+//  Project2
+//
+
+#include "Instrumentation.h"
+#include <iostream>
+#include <iomanip>
+#include <algorithm>
+#include <cstdint>
+using namespace std;
+
+namespace {
+  // one call site and its number of events
+  struct Call_site_count {
+    const void* call_site;
+    long count;
+  };
+
+  // Each histogram is an open-addressing hash table with room for this many
+  // call sites; events from call sites beyond that are counted in overflow.
+  const int histogram_size = 256;
+
+  struct Histogram {
+    Call_site_count call_sites[histogram_size];
+    long overflow;
+  };
+
+  Histogram histograms[NUM_TRACE_EVENTS];
+
+  const char* const event_names[NUM_TRACE_EVENTS] = {
+    "String copy construct", "String move construct",
+    "String copy assign", "String move assign",
+    "List copy construct", "List move construct",
+    "List copy assign", "List move assign",
+    "List insert by copy", "List insert by move"
+  };
+
+  bool more_events(const Call_site_count& lhs, const Call_site_count& rhs)
+  {
+    return lhs.count > rhs.count;
+  }
+}
+
+// Count one event in the histogram for its kind, under the supplied call site.
+void record_trace_event(Trace_event event, const void* call_site) noexcept {
+  Histogram& histogram = histograms[event];
+  uintptr_t hash = reinterpret_cast<uintptr_t>(call_site);
+  int start = int((hash >> 2) % histogram_size);
+  for (int probe = 0; probe < histogram_size; probe++) {
+    Call_site_count& slot = histogram.call_sites[(start + probe) % histogram_size];
+    if (slot.call_site == call_site) {
+      slot.count++;
+      return;
+    }
+    if (!slot.call_site) {
+      slot.call_site = call_site;
+      slot.count = 1;
+      return;
+    }
+  }
+  histogram.overflow++;
+}
+
+// Output each non-empty histogram, with its call sites from most to fewest events.
+void print_trace_histograms(ostream& os) {
+  for (int event = 0; event < NUM_TRACE_EVENTS; event++) {
+    const Histogram& histogram = histograms[event];
+    Call_site_count sorted[histogram_size];
+    int num_call_sites = 0;
+    long total = histogram.overflow;
+    for (const Call_site_count& slot : histogram.call_sites) {
+      if (slot.call_site) {
+        sorted[num_call_sites++] = slot;
+        total += slot.count;
+      }
+    }
+    if (!total) {
+      continue;
+    }
+    sort(sorted, sorted + num_call_sites, more_events);
+    os << event_names[event] << ": " << total << " from " << num_call_sites <<
+    " call sites" << endl;
+    for (int i = 0; i < num_call_sites; i++) {
+      os << setw(10) << sorted[i].count << "  " << sorted[i].call_site << endl;
+    }
+    if (histogram.overflow) {
+      os << setw(10) << histogram.overflow << "  other call sites" << endl;
+    }
+  }
+}
+
+// Empty all of the histograms.
+void clear_trace_histograms() noexcept {
+  for (Histogram& histogram : histograms) {
+    for (Call_site_count& slot : histogram.call_sites) {
+      slot.call_site = nullptr;
+      slot.count = 0;
+    }
+    histogram.overflow = 0;
+  }
+}
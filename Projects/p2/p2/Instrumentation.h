@@ -0,0 +1,69 @@
+//
+//  Instrumentation.h
+//  Project2
+//
+/* The monitoring done by String, Ordered_list, and Unrolled_ordered_list is chosen
+ at compile time by defining P2_INSTRUMENTATION to one of these levels, e.g. with
+ -DP2_INSTRUMENTATION=P2_INSTRUMENT_NONE on the compiler command line:
+
+ P2_INSTRUMENT_NONE - nothing is monitored. The counters are never updated, and
+ the code that would update them is not compiled in at all.
+
+ P2_INSTRUMENT_COUNTERS (the default) - String keeps its number and total
+ allocation, and the lists keep g_Ordered_list_count and g_Ordered_list_Node_count,
+ as p2 reports them.
+
+ P2_INSTRUMENT_TRACING - in addition, String outputs the constructor, destructor,
+ and assignment messages when messages are wanted, and each copy and move of a
+ String or a list, and each insertion into a list by copy or by move, is counted
+ in a histogram by the address it was called from. print_trace_histograms shows
+ the histograms; the addresses can be turned into source lines with a tool such
+ as addr2line or atos.
+
+ Every translation unit in a program must be compiled with the same level, since
+ the String class and the list templates are defined differently for each one.
+ */
+#ifndef INSTRUMENTATION_H
+#define INSTRUMENTATION_H
+#include <iosfwd>
+
+#define P2_INSTRUMENT_NONE 0
+#define P2_INSTRUMENT_COUNTERS 1
+#define P2_INSTRUMENT_TRACING 2
+
+#ifndef P2_INSTRUMENTATION
+#define P2_INSTRUMENTATION P2_INSTRUMENT_COUNTERS
+#endif
+
+// Tests of these constants are resolved by the compiler, so the code they guard
+// is dropped entirely at the levels that do not want it.
+constexpr bool instrument_counters = P2_INSTRUMENTATION >= P2_INSTRUMENT_COUNTERS;
+constexpr bool instrument_tracing = P2_INSTRUMENTATION >= P2_INSTRUMENT_TRACING;
+
+// The kinds of events that are traced, each with its own histogram.
+enum Trace_event {
+  STRING_COPY_CONSTRUCT, STRING_MOVE_CONSTRUCT, STRING_COPY_ASSIGN, STRING_MOVE_ASSIGN,
+  LIST_COPY_CONSTRUCT, LIST_MOVE_CONSTRUCT, LIST_COPY_ASSIGN, LIST_MOVE_ASSIGN,
+  LIST_INSERT_COPY, LIST_INSERT_MOVE,
+  NUM_TRACE_EVENTS
+};
+
+// Count one event in the histogram for its kind, under the supplied call site.
+// No memory is allocated; once a histogram has room for no more call sites,
+// further new ones are counted together.
+void record_trace_event(Trace_event event, const void* call_site) noexcept;
+// Output each non-empty histogram, with its call sites from most to fewest events.
+void print_trace_histograms(std::ostream& os);
+// Empty all of the histograms.
+void clear_trace_histograms() noexcept;
+
+// Trace an event in the calling function, recording the address it was called from.
+// This has to be a macro so that the address is that of the caller's caller. If the
+// function has been inlined, the address is where its caller was called from.
+#if P2_INSTRUMENTATION >= P2_INSTRUMENT_TRACING
+#define P2_TRACE_EVENT(event) record_trace_event((event), __builtin_return_address(0))
+#else
+#define P2_TRACE_EVENT(event) ((void)0)
+#endif
+
+#endif
@@ -31,12 +31,23 @@
  // Thing pointers in order by a custom ordering.
  Ordered_list<Thing*, My_ordering_class> ol_things;
 	
- The only way to add to the list is with the insert function, which automatically
+ The basic way to add to the list is with the insert function, which automatically
  puts the new item in the proper place in the list using the ordering function
  to determine the point of insertion. If a matching object is already in the list
  (as determined by the ordering function) the insertion fails - the list is not
  modified, and false is returned by the insert function.
  
+ The emplace functions construct the new item directly in the list node from
+ the supplied constructor arguments, instead of copying or moving in an object
+ constructed beforehand; try_emplace also takes a key and only constructs the
+ item if no matching item is already in the list.
+ 
+ Many items can be added at once with insert_sorted_range, which merges a range
+ of items that are already in order into the list in a single pass, and with
+ merge, which moves the nodes of another list of the same type into this one
+ without copying or reallocating them. Both skip items that match one already
+ in the list, just like insert.
+ 
  The iterators encapsulate a pointer to the list nodes, and are a public class
  nested within the Ordered_list class, and would be declared e.g. as
  Ordered_list<Thing*, Less_than_ptr>::Iterator;
@@ -64,7 +75,20 @@
  To find an object in the list that matches a supplied "probe" object, the ordering
  function is used to determine equality. That is, the find functions assume that
  if both (x < y) and (y < x) are false, then x == y. This allows both insert and find
- operations to be done with only the less-than relation.
+ operations to be done with only the less-than relation. If the ordering function
+ object class declares a member type named is_transparent, as the standard library
+ does for std::set, find and try_emplace accept a key of any type that the
+ ordering function object can compare with a T, so that no T has to be constructed
+ as a probe. Less_than_ptr is transparent; for example, a list of Thing pointers
+ can be searched with a String if Thing has operator< defined with String in
+ either order.
+ 
+ The nodes are doubly linked in order, and in addition are organized as a skip list:
+ a randomly chosen quarter of the nodes also belong to a first "express lane" that
+ skips over the others, a quarter of those to a second express lane, and so on.
+ find, insert, and erase run down the lanes from the sparsest one, so they take
+ expected O(log n) comparisons instead of scanning the list from the first node.
+ The express lanes are internal to the list; iterators only follow the ordinary links.
  
  When an object is inserted in the list using the copy version of insert,
  a list node is constructed that contains a copy of the supplied object,
@@ -99,15 +123,33 @@
  the container, using iterators to specify the range of items to apply the function
  to.
  
+ The storage for the list nodes is obtained from a node allocator policy, given
+ as an optional third template parameter, NA (for Node Allocator). NA is a class
+ template that is instantiated with the private Node type. The default,
+ Node_new_allocator, gets and frees the storage for each node individually, just
+ like new and delete. Node_arena_allocator instead carves the nodes, and the arrays
+ of express lane links of the nodes in express lanes, out of large blocks owned by
+ the list; a node removed with erase() is recycled for the next insertion, and all
+ of the blocks are released at once when the list is cleared or destroyed. For example:
+ 
+ // Thing objects in order by Thing::operator<, with the nodes kept in an arena.
+ Ordered_list<Thing, Less_than_ref<Thing>, Node_arena_allocator> ol_things;
+ 
  All Ordered_list constructors and the destructor increment/decrement
  g_Ordered_list_count. The list Node constructors and destructor
- increment/decrement g_Ordered_list_Node_count.
+ increment/decrement g_Ordered_list_Node_count, regardless of the allocator policy.
+ This counting is only compiled in if the instrumentation level chosen in
+ Instrumentation.h includes counters, which is the default. At the tracing level,
+ copying and moving a list, and inserting by copy or by move, are also traced.
  */
 #ifndef ORDERED_LIST_H
 #define ORDERED_LIST_H
 #include "p2_globals.h"
+#include "Instrumentation.h"
 #include "Utility.h"
 #include <utility>
+#include <new>
+#include <type_traits>
 #include <cassert>
 // These Function Object Class templates make it simple to use a class's less-than
 // operator for the ordering function in declaring an Ordered_list container.
@@ -120,18 +162,254 @@ struct Less_than_ref {
   bool operator() (const T& t1, const T& t2) const {return t1 < t2;}
 };
 // Compare two pointers (T is a pointer type) using *T's operator<
+// It is transparent: a pointer can also be compared with a key of another type,
+// using the operator< defined between *T and that type.
 template<typename T>
 struct Less_than_ptr {
+  typedef void is_transparent;
   bool operator()(const T p1, const T p2) const {return *p1 < *p2;}
+  template<typename K>
+  bool operator()(const T p, const K& key) const {return *p < key;}
+  template<typename K>
+  bool operator()(const K& key, const T p) const {return key < *p;}
 };
 // A custom ordering function object class is similar, but no template is needed. For example:
 //  struct My_ordering_class {
 //		bool operator() (const Thing* p1, const Thing* p2) const {return /* whatever you want */;}
 //	};
+// These Node Allocator class templates supply the raw storage for the list nodes.
+// N is the node type; an allocator only hands out and takes back storage - the
+// Ordered_list constructs and destroys the Node objects in it. allocate_links() hands
+// out the array of express lane links of a node, of at most max_links pointers to
+// nodes, and deallocate_links() takes it back, given the same number of links.
+// allocate() and allocate_links() may throw
+// std::bad_alloc; the other functions promise not to throw. If releases_in_bulk
+// is true, storage does not have to be deallocated node by node before release().
+// absorb() takes over all of the storage held by another allocator of the same
+// type, so that nodes moved from one list to another can be deallocated by the
+// allocator of the list they were moved to.
+// Get and free the storage for each node individually - the same as new and delete.
+template<typename N>
+class Node_new_allocator {
+public:
+  static const bool releases_in_bulk = false;
+  static const int max_links = 16;
+  void* allocate()
+		{return ::operator new(sizeof(N));}
+  void deallocate(void* node_ptr) noexcept
+		{::operator delete(node_ptr);}
+  N** allocate_links(int num_links)
+		{return static_cast<N**>(::operator new(num_links * sizeof(N*)));}
+  void deallocate_links(N** links_ptr, int) noexcept
+		{::operator delete(links_ptr);}
+  // nothing is held on to, so nothing to release
+  void release() noexcept {}
+  void swap(Node_new_allocator&) noexcept {}
+  void absorb(Node_new_allocator&) noexcept {}
+};
+// Carve the nodes out of blocks that get bigger as the list grows, up to a limit.
+// Deallocated nodes are kept on a free list and reused by the next allocate().
+// The arrays of links are carved out of blocks of their own, and deallocated ones
+// are kept on a free list for each number of links.
+// release() gives all of the blocks back at once, so clearing or destroying a
+// list of n nodes takes a handful of heap operations instead of n of them.
+// Each list has its own arena; a copy of a list starts out with an empty one.
+template<typename N>
+class Node_arena_allocator {
+public:
+  static const bool releases_in_bulk = true;
+  static const int max_links = 16;
+  Node_arena_allocator() noexcept :
+  blocks(nullptr), free_slots(nullptr), next_slot(nullptr), end_slot(nullptr),
+  next_block_size(min_block_size), free_links(), next_link(nullptr), end_link(nullptr),
+  next_link_block_size(min_link_block_size) {}
+  // take over the blocks of the original, leaving it empty
+  Node_arena_allocator(Node_arena_allocator&& original) noexcept :
+  Node_arena_allocator()
+		{swap(original);}
+  ~Node_arena_allocator()
+		{release();}
+  // nodes are never shared between lists, so arenas are not copied
+  Node_arena_allocator(const Node_arena_allocator&) = delete;
+  Node_arena_allocator& operator= (const Node_arena_allocator&) = delete;
+  Node_arena_allocator& operator= (Node_arena_allocator&&) = delete;
+  
+  // Reuse a deallocated slot if there is one, otherwise take the next slot in
+  // the newest block, getting a new block first if that one is used up.
+  void* allocate() {
+    if (free_slots) {
+      Slot* slot_ptr = free_slots;
+      free_slots = slot_ptr->next_free;
+      return slot_ptr;
+    }
+    if (next_slot == end_slot) {
+      add_block();
+    }
+    return next_slot++;
+  }
+  // put the slot on the free list; the block stays allocated until release()
+  void deallocate(void* node_ptr) noexcept {
+    Slot* slot_ptr = static_cast<Slot*>(node_ptr);
+    slot_ptr->next_free = free_slots;
+    free_slots = slot_ptr;
+  }
+  // Reuse a deallocated array of the same number of links if there is one,
+  // otherwise take the next links in the newest link block, getting a new one
+  // first if there are not enough left in it.
+  N** allocate_links(int num_links) {
+    assert(num_links > 0 && num_links <= max_links);
+    N**& free_list = free_links[num_links - 1];
+    if (free_list) {
+      N** links_ptr = free_list;
+      free_list = next_free_links(links_ptr);
+      return links_ptr;
+    }
+    if (end_link - next_link < num_links) {
+      add_link_block();
+    }
+    N** links_ptr = next_link;
+    next_link += num_links;
+    return links_ptr;
+  }
+  // put the array on the free list for its number of links
+  void deallocate_links(N** links_ptr, int num_links) noexcept {
+    N**& free_list = free_links[num_links - 1];
+    links_ptr[0] = reinterpret_cast<N*>(free_list);
+    free_list = links_ptr;
+  }
+  // free every block, which must no longer contain any constructed nodes
+  void release() noexcept {
+    while (blocks) {
+      Block_header* next_block = blocks->next;
+      ::operator delete(blocks);
+      blocks = next_block;
+    }
+    free_slots = next_slot = end_slot = nullptr;
+    next_block_size = min_block_size;
+    for (auto& free_list : free_links) {
+      free_list = nullptr;
+    }
+    next_link = end_link = nullptr;
+    next_link_block_size = min_link_block_size;
+  }
+  void swap(Node_arena_allocator& other) noexcept {
+    std::swap(blocks, other.blocks);
+    std::swap(free_slots, other.free_slots);
+    std::swap(next_slot, other.next_slot);
+    std::swap(end_slot, other.end_slot);
+    std::swap(next_block_size, other.next_block_size);
+    std::swap(free_links, other.free_links);
+    std::swap(next_link, other.next_link);
+    std::swap(end_link, other.end_link);
+    std::swap(next_link_block_size, other.next_link_block_size);
+  }
+  // Add the other arena's blocks, free slots and free links to this one's, leaving
+  // the other empty. The unused ends of the other's newest blocks stay unused until release().
+  void absorb(Node_arena_allocator& other) noexcept {
+    if (!blocks) {
+      swap(other);
+      return;
+    }
+    if (other.blocks) {
+      // the order of the blocks doesn't matter, since they are only freed together
+      Block_header* tail_block = other.blocks;
+      while (tail_block->next) {
+        tail_block = tail_block->next;
+      }
+      tail_block->next = blocks->next;
+      blocks->next = other.blocks;
+    }
+    if (other.free_slots) {
+      Slot* tail_slot = other.free_slots;
+      while (tail_slot->next_free) {
+        tail_slot = tail_slot->next_free;
+      }
+      tail_slot->next_free = free_slots;
+      free_slots = other.free_slots;
+    }
+    for (int i = 0; i < max_links; i++) {
+      if (other.free_links[i]) {
+        N** tail_links = other.free_links[i];
+        while (next_free_links(tail_links)) {
+          tail_links = next_free_links(tail_links);
+        }
+        tail_links[0] = reinterpret_cast<N*>(free_links[i]);
+        free_links[i] = other.free_links[i];
+      }
+    }
+    other.blocks = nullptr;
+    other.free_slots = other.next_slot = other.end_slot = nullptr;
+    other.next_block_size = min_block_size;
+    for (auto& free_list : other.free_links) {
+      free_list = nullptr;
+    }
+    other.next_link = other.end_link = nullptr;
+    other.next_link_block_size = min_link_block_size;
+  }
+  
+private:
+  // a slot either holds a node, or links to the next free slot
+  union Slot {
+    Slot* next_free;
+    typename std::aligned_storage<sizeof(N), alignof(N)>::type storage;
+  };
+  // each block starts with a header linking the blocks; the slots follow it
+  struct alignas(Slot) Block_header {
+    Block_header* next;
+  };
+  static const int min_block_size = 16;   // slots in the first block
+  static const int max_block_size = 4096; // block size stops doubling here
+  // the same for the link blocks, in links; the first must hold max_links
+  static const int min_link_block_size = 64;
+  static const int max_link_block_size = 4096;
+  Block_header* blocks;   // newest block first, node and link blocks alike
+  Slot* free_slots;       // slots given back by deallocate()
+  Slot* next_slot;        // next never-used slot in the newest block
+  Slot* end_slot;         // one past the last slot in the newest block
+  int next_block_size;
+  // free_links[i] is the first free array of i + 1 links; the first link of a free
+  // array points to the next one on the list, instead of to a node
+  N** free_links[max_links];
+  N** next_link;          // next never-used link in the newest link block
+  N** end_link;           // one past the last link in the newest link block
+  int next_link_block_size;
+  
+  static N** next_free_links(N** links_ptr) noexcept
+		{return reinterpret_cast<N**>(links_ptr[0]);}
+  
+  // Get a new block and make it the newest one. If the allocation throws,
+  // the arena is unchanged.
+  void add_block() {
+    void* raw_ptr = ::operator new(sizeof(Block_header) + next_block_size * sizeof(Slot));
+    Block_header* block_ptr = static_cast<Block_header*>(raw_ptr);
+    block_ptr->next = blocks;
+    blocks = block_ptr;
+    next_slot = reinterpret_cast<Slot*>(block_ptr + 1);
+    end_slot = next_slot + next_block_size;
+    if (next_block_size < max_block_size) {
+      next_block_size *= 2;
+    }
+  }
+  // Get a new link block; the rest of the old one is left unused. If the
+  // allocation throws, the arena is unchanged.
+  void add_link_block() {
+    void* raw_ptr = ::operator new(sizeof(Block_header) + next_link_block_size * sizeof(N*));
+    Block_header* block_ptr = static_cast<Block_header*>(raw_ptr);
+    block_ptr->next = blocks;
+    blocks = block_ptr;
+    next_link = reinterpret_cast<N**>(block_ptr + 1);
+    end_link = next_link + next_link_block_size;
+    if (next_link_block_size < max_link_block_size) {
+      next_link_block_size *= 2;
+    }
+  }
+};
 // Note: noexcept is promise that DECLARED function doesn't throw exception!
 // T is the type of the objects in the list - the data item in the list node
 // OF is the ordering function object type, defaulting to Less_than_ref for T
-template<typename T, typename OF = Less_than_ref<T> >
+// NA is the node allocator policy template, defaulting to Node_new_allocator
+template<typename T, typename OF = Less_than_ref<T>,
+template<typename> class NA = Node_new_allocator>
 class Ordered_list {
 public:
   // Default constructor creates an empty container that has an ordering function
@@ -183,35 +461,49 @@ private:
   // to make it clear when the node count should be incremented or decremented.
   // Because it is a private member of Ordered_list, you can add members of your
   // choice, such as special constructors.
+  // a tag to select the Node constructor that constructs the datum in place
+  struct In_place_t {};
   struct Node {
     // Construct a node containing a copy of the T data; the copy operation
     // might throw an exception, so the basic and strong guarantee should
     // be satisfied as long as the copy is attempted before the containing list is
     // modified.
     Node(const T& new_datum, Node* new_prev, Node* new_next) :
-    datum(new_datum), prev(new_prev), next(new_next)
-    {g_Ordered_list_Node_count++;}
+    datum(new_datum), prev(new_prev), next(new_next), express(nullptr), express_levels(0)
+    {if (instrument_counters) {g_Ordered_list_Node_count++;}}
     // Move version of constructs a node using an rvalue reference to the new datum
     // and move constructs the datum member variable from it, using its move constructor.
     Node(T&& new_datum, Node* new_prev, Node* new_next) :
-    datum(std::move(new_datum)), prev(new_prev), next(new_next)
-    {g_Ordered_list_Node_count++;}
+    datum(std::move(new_datum)), prev(new_prev), next(new_next), express(nullptr),
+    express_levels(0)
+    {if (instrument_counters) {g_Ordered_list_Node_count++;}}
+    // Construct the datum in place from the supplied arguments, for emplace.
+    template<typename... Args>
+    Node(In_place_t, Args&&... args) :
+    datum(std::forward<Args>(args)...), prev(nullptr), next(nullptr), express(nullptr),
+    express_levels(0)
+    {if (instrument_counters) {g_Ordered_list_Node_count++;}}
     // Copy constructor, move constructor, and dtor defined only to support allocation
     // counting. Node copy constructor should provide the same basic and strong
-    // guarantee as Node construction.
+    // guarantee as Node construction. The copy is in no express lanes.
     Node(const Node& original) :
-    datum(original.datum), prev(original.prev), next(original.next)
-    {g_Ordered_list_Node_count++;}
+    datum(original.datum), prev(original.prev), next(original.next), express(nullptr),
+    express_levels(0)
+    {if (instrument_counters) {g_Ordered_list_Node_count++;}}
     // The following functions should not be needed and so are deleted
     Node(Node&& original) = delete;
     Node& operator= (const Node& rhs) = delete; // shouldn't be needed
     Node& operator= (Node&& rhs) = delete; // shouldn't be needed
-    // only defined to support allocation counting
+    // defined to support allocation counting; the express links belong to the
+    // node allocator, and are given back to it along with the node
     ~Node()
-    {g_Ordered_list_Node_count--;}
+    {if (instrument_counters) {g_Ordered_list_Node_count--;}}
     T datum;
     Node* prev; // pointer to previous node
     Node* next; // pointer to next node
+    // express[i] is the next node in express lane i + 1; nullptr if in no lanes
+    Node** express;
+    int express_levels; // number of express lanes this node is in
 		};
 		
 public:
@@ -375,14 +667,55 @@ public:
   // into the new list node instead of copying it.
   bool insert(T&& new_datum);
   
+  // Construct a new datum in a new node from the supplied arguments, and insert
+  // it as insert does. The datum is constructed first, since it is what the
+  // position is searched for with, so if an "equal" datum is already in the list,
+  // the new node is destroyed, the list is not modified, and false is returned.
+  // To search before constructing anything, use try_emplace. For an object that
+  // has already been constructed, emplace gains nothing over insert.
+  template<typename... Args>
+  bool emplace(Args&&... args);
+  // Find where a datum matching the key would go, and only if there is no such
+  // datum already, construct a new datum there from the supplied arguments and
+  // return true; otherwise nothing is constructed and false is returned. The new
+  // datum must be equal to the key according to the ordering function. The key is
+  // a T, or any type the ordering function object can compare with a T.
+  template<typename K, typename... Args>
+  bool try_emplace(const K& key, Args&&... args);
+  
+  // Insert copies of the items in the range [first_it, last_it), which should be
+  // in order according to the ordering function, merging them into the list in
+  // a single pass instead of searching for each one. As with insert, an item
+  // that matches one already in the list (or earlier in the range) is skipped.
+  // If an item is out of order, the merge starts over from the front of the list,
+  // so the result is still correct, only slower. Returns the number of items inserted.
+  // The basic exception guarantee: if copying an item throws, the items already
+  // inserted stay in the list, and the exception is propagated.
+  template<typename IT>
+  int insert_sorted_range(IT first_it, IT last_it);
+  
+  // Move all of the nodes of the other list into this one in a single merging
+  // pass, without copying or reallocating them; a node whose datum matches one
+  // already in this list is destroyed instead. The other list is left empty.
+  // Since no type T data is copied, the no-throw guarantee is made.
+  void merge(Ordered_list&& other) noexcept;
+  
   // The find function returns an iterator designating the node containing
   // the datum that according to the ordering function, is equal to the
   // supplied probe_datum; end() is returned if the node is not found.
-  // If a matching item is not present, the scan is terminated as soon as
-  // possible by detecting when the scan goes past where the matching item would be.
+  // The search goes down the express lanes, and stops at the first node
+  // that is not less than the probe_datum.
   Iterator find(const T& probe_datum) noexcept;
   // The const version of find returns a const_Iterator
   const_Iterator find(const T& probe_datum) const noexcept;
+  // If the ordering function object is transparent, find also accepts a key of
+  // any type that the ordering function object can compare with a T.
+  template<typename K, typename O = OF, typename = typename O::is_transparent>
+  Iterator find(const K& probe_key) noexcept
+		{return Iterator(find_node(probe_key));}
+  template<typename K, typename O = OF, typename = typename O::is_transparent>
+  const_Iterator find(const K& probe_key) const noexcept
+		{return const_Iterator(find_node(probe_key));}
   
   // Delete the specified node, specified by a const_Iterator because it only designates
   // the location of the to-be-removed data. This function can be called with an Iterator
@@ -408,8 +741,61 @@ private:
   Node* first;
   Node* last;
   int num_nodes;
-  // private helper function
-  void push_back(const T& datum);
+  // Each lane holds about a quarter of the nodes of the lane below it, so this
+  // many lanes are enough for far more nodes than an int can count.
+  static const int max_express_levels = 16;
+  // express_heads[i] is the first node in express lane i + 1
+  Node* express_heads[max_express_levels];
+  int express_levels; // number of express lanes currently in use
+  unsigned int lane_seed; // state of the generator for choosing node levels
+  // the node allocator, which belongs to this list only
+  NA<Node> node_allocator;
+  static_assert(max_express_levels <= NA<Node>::max_links,
+                "the node allocator must supply the links for every express lane");
+  // private helper functions
+  // Append a copy of datum as the last node; lane_tails holds the last node
+  // so far in each express lane, and is updated.
+  void push_back(const T& datum, Node** lane_tails);
+  // Search down the express lanes for the first node whose datum is not less than
+  // the probe, and return it, or nullptr if there is none. If predecessors is
+  // supplied, predecessors[i] is set to the last node before that position in
+  // lane i + 1 (nullptr standing for the start of the lane) for each lane in use.
+  // The probe is a T, or a key the ordering function object can compare with a T.
+  template<typename K>
+  Node* search(const K& probe_datum, Node** predecessors) const noexcept;
+  // Return the node whose datum matches the probe, or nullptr if there is none.
+  template<typename K>
+  Node* find_node(const K& probe_datum) const noexcept;
+  // Link a new node into the list before position (at the end if nullptr),
+  // including its express lanes, whose predecessors are supplied as from search.
+  void link_before(Node* new_node_ptr, Node* position_ptr, Node** predecessors) noexcept;
+  // Unlink the node from its express lanes and from the list.
+  void unlink(Node* node_ptr) noexcept;
+  // For merging a sorted sequence: advance position_ptr past the nodes that are
+  // less than the datum, keeping predecessors[i] as the last node passed in lane
+  // i + 1, as from search, and return false if the datum matches a node already
+  // in the list. A datum less than the one before position_ptr starts the
+  // merge over from the front of the list.
+  bool seek_merge_position(const T& datum, Node*& position_ptr, Node** predecessors) const noexcept;
+  // Link a node in before position_ptr, and make it the last node passed in its lanes.
+  void link_merged(Node* new_node_ptr, Node* position_ptr, Node** predecessors) noexcept;
+  // The next node after node_ptr in express lane i + 1, or the first node in
+  // the lane if node_ptr is nullptr
+  Node* next_express(const Node* node_ptr, int i) const noexcept
+		{return node_ptr ? node_ptr->express[i] : express_heads[i];}
+  void set_next_express(Node* node_ptr, int i, Node* next_ptr) noexcept
+		{(node_ptr ? node_ptr->express[i] : express_heads[i]) = next_ptr;}
+  // Choose how many express lanes a new node will be in: none with probability
+  // 3/4, at least one with probability 1/4, at least two with 1/16, and so on.
+  int random_express_levels() noexcept;
+  // Construct a Node in storage from the node allocator, forwarding the arguments
+  // to the Node constructor, and give it room for the supplied number of express
+  // lanes. If anything throws, the storage is given back and the exception is
+  // propagated, leaving the list unchanged.
+  template<typename... Args>
+  Node* create_node(int new_express_levels, Args&&... args);
+  // Destroy the Node and give its storage and links back to the node allocator.
+  void destroy_node(Node* node_ptr) noexcept;
 };
 // These function templates are given two iterators, usually .begin() and .end(),
 // and apply a function to each item (dereferenced iterator) in the list.
@@ -468,53 +854,73 @@ bool apply_if_arg(IT first, IT last, F function, A arg)
 // the class declaration.
 // Default constructor creates an empty container that has an ordering function
 // object of the type specified in the second template type parameter (OF).
-template<typename T, typename OF>
-Ordered_list<T, OF>::Ordered_list()
-: first(nullptr), last(nullptr), num_nodes(0) {
-  g_Ordered_list_count++;
+template<typename T, typename OF, template<typename> class NA>
+Ordered_list<T, OF, NA>::Ordered_list()
+: first(nullptr), last(nullptr), num_nodes(0), express_heads(), express_levels(0),
+lane_seed(1) {
+  if (instrument_counters) {
+    g_Ordered_list_count++;
+  }
 }
 // Copy construct this list from another list by copying its data.
 // The basic exception guarantee:
 // If an exception is thrown when the type T contents of a node are copied,
 // any nodes already constructed are destroyed, so that no memory is leaked,
 // and the exception is then propagated from this constructor.
-template<typename T, typename OF>
-Ordered_list<T, OF>::Ordered_list(const Ordered_list& original)
-: first(nullptr), last(nullptr), num_nodes(0)
+template<typename T, typename OF, template<typename> class NA>
+Ordered_list<T, OF, NA>::Ordered_list(const Ordered_list& original)
+: first(nullptr), last(nullptr), num_nodes(0), express_heads(), express_levels(0),
+lane_seed(1)
 {
+  P2_TRACE_EVENT(LIST_COPY_CONSTRUCT);
   Node* copy_node_ptr = original.first;
-  g_Ordered_list_count++;
+  Node* lane_tails[max_express_levels] = {};
   try {
     while(copy_node_ptr) {
-      push_back(copy_node_ptr->datum);
+      push_back(copy_node_ptr->datum, lane_tails);
       copy_node_ptr = copy_node_ptr->next;
     }
   } catch(...) {
     clear();
     throw;
   }
+  // counted only once constructed, since the destructor won't run if the copy throws
+  if (instrument_counters) {
+    g_Ordered_list_count++;
+  }
 }
 // Move construct this list from another list by taking its data,
 // leaving the original in an empty state (like when default constructed).
 // Since no type T data is copied, no exceptions are possible,
 // so the no-throw guarantee is made.
-template<typename T, typename OF>
-Ordered_list<T, OF>::Ordered_list(Ordered_list&& original) noexcept
-:first(original.first), last(original.last), num_nodes(original.num_nodes)
+template<typename T, typename OF, template<typename> class NA>
+Ordered_list<T, OF, NA>::Ordered_list(Ordered_list&& original) noexcept
+:first(original.first), last(original.last), num_nodes(original.num_nodes),
+express_heads(), express_levels(original.express_levels), lane_seed(original.lane_seed),
+node_allocator(std::move(original.node_allocator))
 {
+  P2_TRACE_EVENT(LIST_MOVE_CONSTRUCT);
+  for (int i = 0; i < express_levels; i++) {
+    express_heads[i] = original.express_heads[i];
+    original.express_heads[i] = nullptr;
+  }
   original.first = nullptr;
   original.last = nullptr;
   original.num_nodes = 0;
-  g_Ordered_list_count++;
+  original.express_levels = 0;
+  if (instrument_counters) {
+    g_Ordered_list_count++;
+  }
 }
 // Copy assign this list with a copy of another list, using the copy-swap idiom.
 // Basic and strong exception guarantee:
 // If an exception is thrown during the copy, no memory is leaked, and lhs is unchanged.
-template<typename T, typename OF>
-Ordered_list<T, OF>& Ordered_list<T, OF>::operator= (const Ordered_list& rhs)
+template<typename T, typename OF, template<typename> class NA>
+Ordered_list<T, OF, NA>& Ordered_list<T, OF, NA>::operator= (const Ordered_list& rhs)
 {
+  P2_TRACE_EVENT(LIST_COPY_ASSIGN);
   // copy-swap, make temp list based on rhs
-  Ordered_list<T, OF> temp_list(rhs);
+  Ordered_list<T, OF, NA> temp_list(rhs);
   // swap with current list
   swap(temp_list);
   return *this;
@@ -522,166 +928,176 @@ Ordered_list<T, OF>& Ordered_list<T, OF>::operator= (const Ordered_list& rhs)
 // Move assignment operator simply swaps the current content with the rhs.
 // Since no type T data is copied, no exceptions are possible,
 // so the no-throw guarantee is made.
-template<typename T, typename OF>
-Ordered_list<T, OF>& Ordered_list<T, OF>::operator= (Ordered_list&& rhs) noexcept
+template<typename T, typename OF, template<typename> class NA>
+Ordered_list<T, OF, NA>& Ordered_list<T, OF, NA>::operator= (Ordered_list&& rhs) noexcept
 {
+  P2_TRACE_EVENT(LIST_MOVE_ASSIGN);
   swap(rhs);
   return *this;
 }
 // deallocate all the nodes in this list
-template<typename T, typename OF>
-Ordered_list<T, OF>::~Ordered_list() {
-  g_Ordered_list_count--;
+template<typename T, typename OF, template<typename> class NA>
+Ordered_list<T, OF, NA>::~Ordered_list() {
+  if (instrument_counters) {
+    g_Ordered_list_count--;
+  }
   clear();
 }
 // Delete the nodes in the list, if any, and initialize it.
 // No exceptions are supposed to happen so the no-throw guarantee is made.
-template<typename T, typename OF>
-void Ordered_list<T, OF>::clear() noexcept {
-  while (begin() != end()) {
-    erase(begin());
+template<typename T, typename OF, template<typename> class NA>
+void Ordered_list<T, OF, NA>::clear() noexcept {
+  Node* node_ptr = first;
+  while (node_ptr) {
+    Node* next_node_ptr = node_ptr->next;
+    // an arena gives all of its storage back at once below
+    if (NA<Node>::releases_in_bulk) {
+      node_ptr->~Node();
+    }
+    else {
+      destroy_node(node_ptr);
+    }
+    node_ptr = next_node_ptr;
   }
+  node_allocator.release();
+  first = last = nullptr;
+  num_nodes = 0;
+  for (int i = 0; i < express_levels; i++) {
+    express_heads[i] = nullptr;
+  }
+  express_levels = 0;
 }
 // The insert functions add the new datum to the list using the ordering function.
 // If an "equal" datum is already in the list, then the list is not modified
 // and false is returned. Otherwise, the new datum is inserted, and true is returned.
 // A copy of the datum object is made in the new list node.
-template<typename T, typename OF>
-bool Ordered_list<T, OF>::insert(const T& new_datum) {
+template<typename T, typename OF, template<typename> class NA>
+bool Ordered_list<T, OF, NA>::insert(const T& new_datum) {
+  P2_TRACE_EVENT(LIST_INSERT_COPY);
   // first find correct insertion spot
-  Node* insert_node_ptr = first;
-  while(insert_node_ptr) {
-    // still haven't found yet, data in node < new_datum
-    if(ordering_fobj(insert_node_ptr->datum, new_datum)) {
-      insert_node_ptr = insert_node_ptr->next;
-    }
-    else {
-      // data already exist
-      if(!ordering_fobj(new_datum, insert_node_ptr->datum)) {
-        return false;
-      }
-      // found the spot
-      break;
-    }
+  Node* predecessors[max_express_levels];
+  Node* insert_node_ptr = search(new_datum, predecessors);
+  // data already exist
+  if(insert_node_ptr && !ordering_fobj(new_datum, insert_node_ptr->datum)) {
+    return false;
   }
-  Node* new_node_ptr = new Node(new_datum, nullptr, nullptr);
+  Node* new_node_ptr = create_node(random_express_levels(), new_datum, nullptr, nullptr);
   //insertion into correct spot
-  if(empty()) {
-    first = new_node_ptr;
-    last = new_node_ptr;
-    num_nodes++;
-    return true;
-  }
-  if(!insert_node_ptr) {
-    if(ordering_fobj(new_datum, first->datum)) {
-      first->prev = new_node_ptr;
-      new_node_ptr->next = first;
-      first = new_node_ptr;
-    }
-    else {
-      last->next = new_node_ptr;
-      new_node_ptr->prev = last;
-      last = new_node_ptr;
-    }
-  }
-  else {
-    if(insert_node_ptr->prev) {
-      insert_node_ptr->prev->next = new_node_ptr;
-    }
-    else {
-      first = new_node_ptr;
-    }
-    new_node_ptr->prev = insert_node_ptr->prev;
-    new_node_ptr->next = insert_node_ptr;
-    insert_node_ptr->prev = new_node_ptr;
-  }
-  num_nodes++;
+  link_before(new_node_ptr, insert_node_ptr, predecessors);
   return true;
 }
 
 // This version of insert provides for moving the contents of a datum
 // into the new list node instead of copying it.
-template<typename T, typename OF>
-bool Ordered_list<T, OF>::insert(T&& new_datum) {
-  Node* insert_node_ptr = first;
-  while(insert_node_ptr) {
-    // still haven't found yet, data in node < new_datum
-    if(ordering_fobj(insert_node_ptr->datum, new_datum)) {
-      insert_node_ptr = insert_node_ptr->next;
-    }
-    else {
-      if(!ordering_fobj(new_datum, insert_node_ptr->datum)) {
-        return false;
-      }
-      break;
-    }
+template<typename T, typename OF, template<typename> class NA>
+bool Ordered_list<T, OF, NA>::insert(T&& new_datum) {
+  P2_TRACE_EVENT(LIST_INSERT_MOVE);
+  Node* predecessors[max_express_levels];
+  Node* insert_node_ptr = search(new_datum, predecessors);
+  if(insert_node_ptr && !ordering_fobj(new_datum, insert_node_ptr->datum)) {
+    return false;
   }
-  Node* new_node_ptr = new Node(std::move(new_datum), nullptr, nullptr);
-  if(empty()) {
-    first = new_node_ptr;
-    last = new_node_ptr;
-    num_nodes++;
-    return true;
+  Node* new_node_ptr = create_node(random_express_levels(), std::move(new_datum),
+                                   nullptr, nullptr);
+  link_before(new_node_ptr, insert_node_ptr, predecessors);
+  return true;
+}
+// Construct a new datum in a new node from the supplied arguments, and insert it
+// as insert does; if an "equal" datum is already in the list, the node is destroyed.
+template<typename T, typename OF, template<typename> class NA>
+template<typename... Args>
+bool Ordered_list<T, OF, NA>::emplace(Args&&... args) {
+  // the datum has to exist before it can be compared
+  Node* new_node_ptr = create_node(random_express_levels(), In_place_t(),
+                                   std::forward<Args>(args)...);
+  Node* predecessors[max_express_levels];
+  Node* insert_node_ptr = search(new_node_ptr->datum, predecessors);
+  if(insert_node_ptr && !ordering_fobj(new_node_ptr->datum, insert_node_ptr->datum)) {
+    destroy_node(new_node_ptr);
+    return false;
   }
-  if(!insert_node_ptr) {
-    if(ordering_fobj(new_datum, first->datum)) {
-      first->prev = new_node_ptr;
-      new_node_ptr->next = first;
-      first = new_node_ptr;
-    }
-    else {
-      last->next = new_node_ptr;
-      new_node_ptr->prev = last;
-      last = new_node_ptr;
+  link_before(new_node_ptr, insert_node_ptr, predecessors);
+  return true;
+}
+// Find where a datum matching the key would go, and only if there is no such
+// datum already, construct a new datum there from the supplied arguments.
+template<typename T, typename OF, template<typename> class NA>
+template<typename K, typename... Args>
+bool Ordered_list<T, OF, NA>::try_emplace(const K& key, Args&&... args) {
+  Node* predecessors[max_express_levels];
+  Node* insert_node_ptr = search(key, predecessors);
+  if(insert_node_ptr && !ordering_fobj(key, insert_node_ptr->datum)) {
+    return false;
+  }
+  Node* new_node_ptr = create_node(random_express_levels(), In_place_t(),
+                                   std::forward<Args>(args)...);
+  link_before(new_node_ptr, insert_node_ptr, predecessors);
+  return true;
+}
+// Insert copies of the items in the range [first_it, last_it), which should be
+// in order according to the ordering function, merging them into the list in
+// a single pass instead of searching for each one. Returns the number inserted.
+template<typename T, typename OF, template<typename> class NA>
+template<typename IT>
+int Ordered_list<T, OF, NA>::insert_sorted_range(IT first_it, IT last_it) {
+  Node* position_ptr = first;
+  Node* predecessors[max_express_levels] = {};
+  int num_inserted = 0;
+  for (; first_it != last_it; ++first_it) {
+    if (!seek_merge_position(*first_it, position_ptr, predecessors)) {
+      continue;
     }
+    Node* new_node_ptr = create_node(random_express_levels(), *first_it, nullptr, nullptr);
+    link_merged(new_node_ptr, position_ptr, predecessors);
+    num_inserted++;
   }
-  else {
-    if(insert_node_ptr->prev) {
-      insert_node_ptr->prev->next = new_node_ptr;
+  return num_inserted;
+}
+// Move all of the nodes of the other list into this one in a single merging
+// pass, without copying or reallocating them; a node whose datum matches one
+// already in this list is destroyed instead. The other list is left empty.
+template<typename T, typename OF, template<typename> class NA>
+void Ordered_list<T, OF, NA>::merge(Ordered_list&& other) noexcept {
+  if (&other == this) {
+    return;
+  }
+  // the other list's nodes will be deallocated by this list's allocator from now on
+  node_allocator.absorb(other.node_allocator);
+  Node* other_node_ptr = other.first;
+  other.first = other.last = nullptr;
+  other.num_nodes = 0;
+  for (int i = 0; i < other.express_levels; i++) {
+    other.express_heads[i] = nullptr;
+  }
+  other.express_levels = 0;
+  
+  Node* position_ptr = first;
+  Node* predecessors[max_express_levels] = {};
+  while (other_node_ptr) {
+    Node* next_node_ptr = other_node_ptr->next;
+    // the node keeps its express lanes, which are relinked into this list
+    if (seek_merge_position(other_node_ptr->datum, position_ptr, predecessors)) {
+      link_merged(other_node_ptr, position_ptr, predecessors);
     }
     else {
-      first = new_node_ptr;
+      destroy_node(other_node_ptr);
     }
-    new_node_ptr->prev = insert_node_ptr->prev;
-    new_node_ptr->next = insert_node_ptr;
-    insert_node_ptr->prev = new_node_ptr;
+    other_node_ptr = next_node_ptr;
   }
-  num_nodes++;
-  return true;
 }
 // The find function returns an iterator designating the node containing
 // the datum that according to the ordering function, is equal to the
 // supplied probe_datum; end() is returned if the node is not found.
-// If a matching item is not present, the scan is terminated as soon as
-// possible by detecting when the scan goes past where the matching item would be.
-template<typename T, typename OF>
-typename Ordered_list<T, OF>::Iterator Ordered_list<T, OF>::find(const T& probe_datum) noexcept {
-  Node *node = first;
-  while (node) {
-    if (!ordering_fobj(node->datum, probe_datum)) {
-      if (!ordering_fobj(probe_datum, node->datum)) {
-        return Iterator(node);
-      }
-      break;
-    }
-    node = node->next;
-  }
-  return nullptr;
+// The search goes down the express lanes, and stops at the first node
+// that is not less than the probe_datum.
+template<typename T, typename OF, template<typename> class NA>
+typename Ordered_list<T, OF, NA>::Iterator Ordered_list<T, OF, NA>::find(const T& probe_datum) noexcept {
+  return Iterator(find_node(probe_datum));
 }
 // The const version of find returns a const_Iterator
-template<typename T, typename OF>
-typename Ordered_list<T, OF>::const_Iterator Ordered_list<T, OF>::find(const T& probe_datum) const noexcept {
-  Node *node = first;
-  while (node) {
-    if (!ordering_fobj(node->datum, probe_datum)) {
-      if (!ordering_fobj(probe_datum, node->datum)) {
-        return const_Iterator(node);
-      }
-      break;
-    }
-    node = node->next;
-  }
-  return nullptr;
+template<typename T, typename OF, template<typename> class NA>
+typename Ordered_list<T, OF, NA>::const_Iterator Ordered_list<T, OF, NA>::find(const T& probe_datum) const noexcept {
+  return const_Iterator(find_node(probe_datum));
 }
 // Delete the specified node, specified by a const_Iterator because it only designates
 // the location of the to-be-removed data. This function can be called with an Iterator
@@ -690,24 +1106,14 @@ typename Ordered_list<T, OF>::const_Iterator Ordered_list<T, OF>::find(const T&
 // Do not attempt to dereference the iterator after calling this function - it
 // is invalid after this function executes. The results are undefined if the
 // Iterator does not point to an actual node, or the list is empty.
-template<typename T, typename OF>
-void Ordered_list<T, OF>::erase(const_Iterator it) noexcept {
+template<typename T, typename OF, template<typename> class NA>
+void Ordered_list<T, OF, NA>::erase(const_Iterator it) noexcept {
   assert(it.node_ptr);
   if (it != end()) {
-    if(it.node_ptr ->next) {
-      it.node_ptr->next->prev = it.node_ptr->prev;
-    }
-    else {
-      last = it.node_ptr->prev;
-    }
-    if (it.node_ptr->prev) {
-      it.node_ptr->prev->next = it.node_ptr->next;
-    }
-    else {
-      first = it.node_ptr->next;
-    }
-    num_nodes--;
-    delete it.node_ptr;
+    // the iterator only designates the node, which belongs to this list
+    Node* node_ptr = const_cast<Node*>(it.node_ptr);
+    unlink(node_ptr);
+    destroy_node(node_ptr);
   }
 }
 /// Interchange the member variable values of this list with the other list;
@@ -717,23 +1123,229 @@ void Ordered_list<T, OF>::erase(const_Iterator it) noexcept {
 // This function can only be called with an other list of the same type as
 // this list, which means that the ordering function objects must be identical, and
 // so do not need to be swapped.
-template<typename T, typename OF>
-void Ordered_list<T, OF>::swap(Ordered_list & other) noexcept {
+template<typename T, typename OF, template<typename> class NA>
+void Ordered_list<T, OF, NA>::swap(Ordered_list & other) noexcept {
   std::swap(first, other.first);
   std::swap(last, other.last);
   std::swap(num_nodes, other.num_nodes);
+  std::swap(express_heads, other.express_heads);
+  std::swap(express_levels, other.express_levels);
+  std::swap(lane_seed, other.lane_seed);
+  node_allocator.swap(other.node_allocator);
 }
-// private helper
-template<typename T, typename OF>
-void Ordered_list<T, OF>::push_back(const T& datum) {
+// private helpers
+// Append a copy of datum as the last node; lane_tails holds the last node
+// so far in each express lane, and is updated.
+template<typename T, typename OF, template<typename> class NA>
+void Ordered_list<T, OF, NA>::push_back(const T& datum, Node** lane_tails) {
+  Node* new_node_ptr = create_node(random_express_levels(), datum, last, nullptr);
   if (!first) {
-    first = last = new Node(datum, first, nullptr);
+    first = last = new_node_ptr;
   }
   // modify the next pointer of the ex-last node
   else {
-    last->next = new Node(datum, first, nullptr);
+    last->next = new_node_ptr;
     last = last->next;
   }
+  for (int i = 0; i < new_node_ptr->express_levels; i++) {
+    set_next_express(lane_tails[i], i, new_node_ptr);
+    lane_tails[i] = new_node_ptr;
+  }
+  if (new_node_ptr->express_levels > express_levels) {
+    express_levels = new_node_ptr->express_levels;
+  }
+  num_nodes++;
+}
+// Search down the express lanes for the first node whose datum is not less than
+// the probe, and return it, or nullptr if there is none. If predecessors is
+// supplied, predecessors[i] is set to the last node before that position in
+// lane i + 1 (nullptr standing for the start of the lane) for each lane in use.
+template<typename T, typename OF, template<typename> class NA>
+template<typename K>
+typename Ordered_list<T, OF, NA>::Node* Ordered_list<T, OF, NA>::search(const K& probe_datum,
+                                                                      Node** predecessors) const noexcept {
+  // nullptr is the start of every lane
+  Node* node_ptr = nullptr;
+  for (int i = express_levels - 1; i >= 0; i--) {
+    Node* next_ptr;
+    while ((next_ptr = next_express(node_ptr, i)) && ordering_fobj(next_ptr->datum, probe_datum)) {
+      node_ptr = next_ptr;
+    }
+    if (predecessors) {
+      predecessors[i] = node_ptr;
+    }
+  }
+  // finish along the ordinary links
+  node_ptr = node_ptr ? node_ptr->next : first;
+  while (node_ptr && ordering_fobj(node_ptr->datum, probe_datum)) {
+    node_ptr = node_ptr->next;
+  }
+  return node_ptr;
+}
+// Return the node whose datum matches the probe, or nullptr if there is none.
+template<typename T, typename OF, template<typename> class NA>
+template<typename K>
+typename Ordered_list<T, OF, NA>::Node* Ordered_list<T, OF, NA>::find_node(const K& probe_datum) const noexcept {
+  Node* node_ptr = search(probe_datum, nullptr);
+  if (node_ptr && !ordering_fobj(probe_datum, node_ptr->datum)) {
+    return node_ptr;
+  }
+  return nullptr;
+}
+// Link a new node into the list before position (at the end if nullptr),
+// including its express lanes, whose predecessors are supplied as from search.
+template<typename T, typename OF, template<typename> class NA>
+void Ordered_list<T, OF, NA>::link_before(Node* new_node_ptr, Node* position_ptr,
+                                          Node** predecessors) noexcept {
+  new_node_ptr->next = position_ptr;
+  new_node_ptr->prev = position_ptr ? position_ptr->prev : last;
+  if (new_node_ptr->prev) {
+    new_node_ptr->prev->next = new_node_ptr;
+  }
+  else {
+    first = new_node_ptr;
+  }
+  if (position_ptr) {
+    position_ptr->prev = new_node_ptr;
+  }
+  else {
+    last = new_node_ptr;
+  }
+  for (int i = 0; i < new_node_ptr->express_levels; i++) {
+    // a lane not yet in use starts out empty
+    Node* predecessor_ptr = (i < express_levels) ? predecessors[i] : nullptr;
+    new_node_ptr->express[i] = next_express(predecessor_ptr, i);
+    set_next_express(predecessor_ptr, i, new_node_ptr);
+  }
+  if (new_node_ptr->express_levels > express_levels) {
+    express_levels = new_node_ptr->express_levels;
+  }
   num_nodes++;
 }
+// Unlink the node from its express lanes and from the list.
+template<typename T, typename OF, template<typename> class NA>
+void Ordered_list<T, OF, NA>::unlink(Node* node_ptr) noexcept {
+  // find the node's predecessor in each of its lanes, looking for the node itself
+  // rather than its datum; the lanes above the node's own only speed up the search
+  Node* predecessor_ptr = nullptr;
+  for (int i = express_levels - 1; i >= 0; i--) {
+    Node* next_ptr;
+    while ((next_ptr = next_express(predecessor_ptr, i)) && next_ptr != node_ptr &&
+           ordering_fobj(next_ptr->datum, node_ptr->datum)) {
+      predecessor_ptr = next_ptr;
+    }
+    if (i < node_ptr->express_levels) {
+      assert(next_ptr == node_ptr);
+      set_next_express(predecessor_ptr, i, node_ptr->express[i]);
+    }
+  }
+  while (express_levels > 0 && !express_heads[express_levels - 1]) {
+    express_levels--;
+  }
+  if(node_ptr->next) {
+    node_ptr->next->prev = node_ptr->prev;
+  }
+  else {
+    last = node_ptr->prev;
+  }
+  if (node_ptr->prev) {
+    node_ptr->prev->next = node_ptr->next;
+  }
+  else {
+    first = node_ptr->next;
+  }
+  num_nodes--;
+}
+// For merging a sorted sequence: advance position_ptr past the nodes that are
+// less than the datum, keeping predecessors[i] as the last node passed in lane
+// i + 1, and return false if the datum matches a node already in the list.
+template<typename T, typename OF, template<typename> class NA>
+bool Ordered_list<T, OF, NA>::seek_merge_position(const T& datum, Node*& position_ptr,
+                                                  Node** predecessors) const noexcept {
+  Node* before_ptr = position_ptr ? position_ptr->prev : last;
+  // out of order, so start over from the front of the list
+  if (before_ptr && ordering_fobj(datum, before_ptr->datum)) {
+    position_ptr = first;
+    for (int i = 0; i < max_express_levels; i++) {
+      predecessors[i] = nullptr;
+    }
+  }
+  while (position_ptr && ordering_fobj(position_ptr->datum, datum)) {
+    for (int i = 0; i < position_ptr->express_levels; i++) {
+      predecessors[i] = position_ptr;
+    }
+    position_ptr = position_ptr->next;
+  }
+  // the datum is not less than the node before the position, and not greater
+  // than the node at the position, so it can only match one of those two
+  before_ptr = position_ptr ? position_ptr->prev : last;
+  if (position_ptr && !ordering_fobj(datum, position_ptr->datum)) {
+    return false;
+  }
+  return !(before_ptr && !ordering_fobj(before_ptr->datum, datum));
+}
+// Link a node in before position_ptr, and make it the last node passed in its lanes.
+template<typename T, typename OF, template<typename> class NA>
+void Ordered_list<T, OF, NA>::link_merged(Node* new_node_ptr, Node* position_ptr,
+                                          Node** predecessors) noexcept {
+  link_before(new_node_ptr, position_ptr, predecessors);
+  for (int i = 0; i < new_node_ptr->express_levels; i++) {
+    predecessors[i] = new_node_ptr;
+  }
+}
+// Choose how many express lanes a new node will be in: none with probability
+// 3/4, at least one with probability 1/4, at least two with 1/16, and so on.
+// A xorshift generator supplies 32 random bits, two of which are used per lane.
+template<typename T, typename OF, template<typename> class NA>
+int Ordered_list<T, OF, NA>::random_express_levels() noexcept {
+  lane_seed ^= lane_seed << 13;
+  lane_seed ^= lane_seed >> 17;
+  lane_seed ^= lane_seed << 5;
+  unsigned int bits = lane_seed;
+  int levels = 0;
+  while (levels < max_express_levels && !(bits & 3u)) {
+    levels++;
+    bits >>= 2;
+  }
+  return levels;
+}
+// Construct a Node in storage from the node allocator, forwarding the arguments
+// to the Node constructor, and give it room for the supplied number of express
+// lanes. If anything throws, the storage is given back and the exception is
+// propagated, leaving the list unchanged.
+template<typename T, typename OF, template<typename> class NA>
+template<typename... Args>
+typename Ordered_list<T, OF, NA>::Node* Ordered_list<T, OF, NA>::create_node(int new_express_levels,
+                                                                           Args&&... args) {
+  void* storage_ptr = node_allocator.allocate();
+  Node* node_ptr;
+  try {
+    node_ptr = new (storage_ptr) Node(std::forward<Args>(args)...);
+  } catch(...) {
+    node_allocator.deallocate(storage_ptr);
+    throw;
+  }
+  if (new_express_levels) {
+    try {
+      node_ptr->express = node_allocator.allocate_links(new_express_levels);
+    } catch(...) {
+      destroy_node(node_ptr);
+      throw;
+    }
+    for (int i = 0; i < new_express_levels; i++) {
+      node_ptr->express[i] = nullptr;
+    }
+    node_ptr->express_levels = new_express_levels;
+  }
+  return node_ptr;
+}
+// Destroy the Node and give its storage and links back to the node allocator.
+template<typename T, typename OF, template<typename> class NA>
+void Ordered_list<T, OF, NA>::destroy_node(Node* node_ptr) noexcept {
+  if (node_ptr->express_levels) {
+    node_allocator.deallocate_links(node_ptr->express, node_ptr->express_levels);
+  }
+  node_ptr->~Node();
+  node_allocator.deallocate(node_ptr);
+}
 #endif
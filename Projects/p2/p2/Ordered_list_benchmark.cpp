@@ -0,0 +1,418 @@
+/*
+ This is a benchmark of the Ordered_list template.
+ 
+ The "allocation" section times the operations whose cost is dominated by the list
+ nodes: copy construction, clearing, and a churn of inserts and erases. Each one is
+ run with the default node allocator policy, which gets each node from the heap,
+ and with the arena policy, which carves them out of blocks.
+ 
+ The "search" section times find and insert in lists from 1000 elements up, in
+ nanoseconds per call, next to a plain scan along the list from the first node.
+ The scan is only timed for the smaller lists, where it finishes in reasonable time.
+ 
+ The "layout" section compares Ordered_list with Unrolled_ordered_list for a list
+ of pointers, like the Record* lists in p2: the heap bytes used per item, the time
+ per item to traverse the list with apply, and the time per find. An Ordered_list
+ is traversed both when it was built in order, so that its nodes happen to be
+ adjacent in memory, and when it was built in random order, so that they are
+ scattered as in a long-running program. The Unrolled_ordered_list is built with
+ insert_sorted_range, since inserting in random order takes time linear in the
+ number of chunks for each item.
+ 
+ Build it with optimization, e.g. with "make olbench", then run it, optionally
+ naming one section and the largest list size for the search and layout sections,
+ e.g. "olbenchexe search 10000000". By default all sections run, up to 1000000.
+ "make olbench_traced" builds it at the tracing instrumentation level instead, as
+ olbenchtracedexe, which ends by showing on cerr where the lists were copied and
+ moved and inserted into by copy and by move; its times include the tracing.
+ */
+#include "Ordered_list.h"
+#include "Unrolled_ordered_list.h"
+#include "p2_globals.h"
+
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <cstddef>
+#include <new>
+
+using namespace std;
+
+typedef Ordered_list<int> Heap_list_t;
+typedef Ordered_list<int, Less_than_ref<int>, Node_arena_allocator> Arena_list_t;
+typedef Ordered_list<int*, Less_than_ptr<int*>> Pointer_list_t;
+typedef Unrolled_ordered_list<int*, Less_than_ptr<int*>> Unrolled_pointer_list_t;
+
+// Heap bytes currently in use, kept up to date by the replacement operator new
+// and delete below, which store the size of each block just in front of it.
+size_t g_heap_bytes = 0;
+const size_t heap_header_size = alignof(max_align_t);
+
+void* operator new(size_t size)
+{
+  void* raw_ptr = malloc(size + heap_header_size);
+  if (!raw_ptr) {
+    throw bad_alloc();
+  }
+  *static_cast<size_t*>(raw_ptr) = size;
+  g_heap_bytes += size;
+  return static_cast<char*>(raw_ptr) + heap_header_size;
+}
+
+void operator delete(void* ptr) noexcept
+{
+  if (ptr) {
+    void* raw_ptr = static_cast<char*>(ptr) - heap_header_size;
+    g_heap_bytes -= *static_cast<size_t*>(raw_ptr);
+    free(raw_ptr);
+  }
+}
+
+void operator delete(void* ptr, size_t) noexcept
+{
+  operator delete(ptr);
+}
+
+// milliseconds since the supplied start time
+double elapsed_ms(chrono::steady_clock::time_point start);
+// a simple linear congruential generator so that runs are repeatable
+int next_random(unsigned int& seed);
+void print_heading(const char* title);
+void print_row(int size, double heap_ms, double arena_ms);
+void run_allocation_section();
+void run_search_section(int largest_size);
+void run_layout_section(int largest_size);
+
+template<typename L>
+void fill_list(L& list, int size);
+template<typename L>
+double time_copy(int size, int repetitions);
+template<typename L>
+double time_clear(int size, int repetitions);
+template<typename L>
+double time_insert_churn(int size, int rounds);
+double find_ns(Heap_list_t& list, int size, int queries);
+double scan_ns(Heap_list_t& list, int size, int queries);
+double insert_ns(Heap_list_t& list, int size, int inserts);
+void shuffle(int** item_ptrs, int size, unsigned int seed);
+template<typename L>
+double traverse_ns(const L& list, int repetitions);
+template<typename L>
+double pointer_find_ns(const L& list, int size, int queries);
+void add_pointed_to(int* item_ptr, long& sum);
+
+int main(int argc, char* argv[])
+{
+  const char* section = (argc > 1) ? argv[1] : "all";
+  int largest_size = (argc > 2) ? atoi(argv[2]) : 1000000;
+  if (!strcmp(section, "all") || !strcmp(section, "allocation")) {
+    run_allocation_section();
+  }
+  if (!strcmp(section, "all") || !strcmp(section, "search")) {
+    run_search_section(largest_size);
+  }
+  if (!strcmp(section, "all") || !strcmp(section, "layout")) {
+    run_layout_section(largest_size);
+  }
+  cout << "\nLists: " << g_Ordered_list_count << ", List Nodes: " <<
+  g_Ordered_list_Node_count << endl;
+  if (instrument_tracing) {
+    print_trace_histograms(cerr);
+  }
+  return 0;
+}
+
+void run_allocation_section()
+{
+  const int sizes[] = {1000, 10000, 100000};
+  
+  print_heading("Copy construction, 10 copies");
+  for (int size : sizes) {
+    print_row(size, time_copy<Heap_list_t>(size, 10), time_copy<Arena_list_t>(size, 10));
+  }
+  
+  print_heading("Fill then clear, 10 times");
+  for (int size : sizes) {
+    print_row(size, time_clear<Heap_list_t>(size, 10), time_clear<Arena_list_t>(size, 10));
+  }
+  
+  print_heading("Insert churn at the front, 100000 erase/insert pairs");
+  for (int size : sizes) {
+    print_row(size, time_insert_churn<Heap_list_t>(size, 100000),
+              time_insert_churn<Arena_list_t>(size, 100000));
+  }
+}
+
+void run_search_section(int largest_size)
+{
+  const int scan_limit = 100000;
+  cout << "\nSearch, ns per call" << endl;
+  cout << setw(10) << "size" << setw(14) << "find" << setw(14) << "insert" <<
+  setw(14) << "scan find" << endl;
+  for (int size = 1000; size <= largest_size; size *= 10) {
+    Heap_list_t list;
+    fill_list(list, size);
+    cout << fixed << setprecision(1);
+    cout << setw(10) << size << setw(14) << find_ns(list, size, 100000) <<
+    setw(14) << insert_ns(list, size, 100000);
+    if (size <= scan_limit) {
+      cout << setw(14) << scan_ns(list, size, 1000) << endl;
+    }
+    else {
+      cout << setw(14) << "-" << endl;
+    }
+  }
+}
+
+void run_layout_section(int largest_size)
+{
+  cout << "\nLayout for lists of pointers, heap bytes per item and ns per item or call" << endl;
+  cout << setw(10) << "size" << setw(10) << "list B" << setw(10) << "unroll B" <<
+  setw(12) << "list walk" << setw(12) << "shuffled" << setw(12) << "unroll walk" <<
+  setw(12) << "list find" << setw(12) << "unroll find" << endl;
+  for (int size = 1000; size <= largest_size; size *= 10) {
+    // the pointed-to values are the even numbers, in order in the array
+    int* values = new int[size];
+    int** item_ptrs = new int*[size];
+    for (int i = 0; i < size; i++) {
+      values[i] = 2 * i;
+      item_ptrs[i] = values + i;
+    }
+    // repeat the traversals enough times to take a measurable time
+    int repetitions = 10000000 / size + 1;
+    size_t heap_bytes_before = g_heap_bytes;
+    Pointer_list_t list;
+    list.insert_sorted_range(item_ptrs, item_ptrs + size);
+    double list_bytes = double(g_heap_bytes - heap_bytes_before) / size;
+    double list_walk_ns = traverse_ns(list, repetitions);
+    double list_find_ns = pointer_find_ns(list, size, 100000);
+    list.clear();
+    
+    shuffle(item_ptrs, size, 4);
+    Pointer_list_t shuffled_list;
+    for (int i = 0; i < size; i++) {
+      shuffled_list.insert(item_ptrs[i]);
+    }
+    double shuffled_walk_ns = traverse_ns(shuffled_list, repetitions);
+    shuffled_list.clear();
+    
+    for (int i = 0; i < size; i++) {
+      item_ptrs[i] = values + i;
+    }
+    heap_bytes_before = g_heap_bytes;
+    Unrolled_pointer_list_t unrolled_list;
+    unrolled_list.insert_sorted_range(item_ptrs, item_ptrs + size);
+    double unrolled_bytes = double(g_heap_bytes - heap_bytes_before) / size;
+    double unrolled_walk_ns = traverse_ns(unrolled_list, repetitions);
+    // the unrolled list's find is linear in the number of chunks, so it gets fewer queries
+    double unrolled_find_ns = pointer_find_ns(unrolled_list, size, 10000000 / size + 10);
+    unrolled_list.clear();
+    
+    cout << fixed << setprecision(1);
+    cout << setw(10) << size << setw(10) << list_bytes << setw(10) << unrolled_bytes <<
+    setw(12) << list_walk_ns << setw(12) << shuffled_walk_ns << setw(12) << unrolled_walk_ns <<
+    setw(12) << list_find_ns << setw(12) << unrolled_find_ns << endl;
+    delete[] item_ptrs;
+    delete[] values;
+  }
+}
+
+double elapsed_ms(chrono::steady_clock::time_point start)
+{
+  return chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+}
+
+int next_random(unsigned int& seed)
+{
+  seed = seed * 1103515245u + 12345u;
+  return int(seed >> 1);
+}
+
+void print_heading(const char* title)
+{
+  cout << "\n" << title << endl;
+  cout << setw(10) << "size" << setw(14) << "heap ms" << setw(14) << "arena ms" << endl;
+}
+
+void print_row(int size, double heap_ms, double arena_ms)
+{
+  cout << fixed << setprecision(2);
+  cout << setw(10) << size << setw(14) << heap_ms << setw(14) << arena_ms << endl;
+}
+
+// Fill the list with the even numbers 2 through 2 * size. Inserting them in
+// descending order puts each new item at the front, so the fill is linear.
+template<typename L>
+void fill_list(L& list, int size)
+{
+  for (int i = size; i > 0; --i) {
+    list.insert(2 * i);
+  }
+}
+
+template<typename L>
+double time_copy(int size, int repetitions)
+{
+  L original;
+  fill_list(original, size);
+  auto start = chrono::steady_clock::now();
+  for (int i = 0; i < repetitions; ++i) {
+    L copy(original);
+  }
+  return elapsed_ms(start);
+}
+
+template<typename L>
+double time_clear(int size, int repetitions)
+{
+  double total_ms = 0.;
+  for (int i = 0; i < repetitions; ++i) {
+    L list;
+    fill_list(list, size);
+    auto start = chrono::steady_clock::now();
+    list.clear();
+    total_ms += elapsed_ms(start);
+  }
+  return total_ms;
+}
+
+// Repeatedly erase the first node and insert a new smallest item, so that
+// the cost is the node allocation and deallocation, not the search.
+template<typename L>
+double time_insert_churn(int size, int rounds)
+{
+  L list;
+  fill_list(list, size);
+  unsigned int seed = 1;
+  int smallest = 0;
+  auto start = chrono::steady_clock::now();
+  for (int i = 0; i < rounds; ++i) {
+    list.erase(list.begin());
+    // each new item is smaller than all of the others
+    smallest -= 1 + 2 * (next_random(seed) % 4);
+    list.insert(smallest);
+  }
+  return elapsed_ms(start);
+}
+
+// Look up random values between 1 and 2 * size, half of which are in the list.
+double find_ns(Heap_list_t& list, int size, int queries)
+{
+  unsigned int seed = 2;
+  int found = 0;
+  auto start = chrono::steady_clock::now();
+  for (int i = 0; i < queries; ++i) {
+    if (list.find(1 + next_random(seed) % (2 * size)) != list.end()) {
+      found++;
+    }
+  }
+  double ns = elapsed_ms(start) * 1.0e6 / queries;
+  // use the result so that the lookups can't be optimized away
+  if (found > queries) {
+    cout << found;
+  }
+  return ns;
+}
+
+// Look up the same kind of values by walking the list from the first node,
+// which is what find cost before the list had express lanes.
+double scan_ns(Heap_list_t& list, int size, int queries)
+{
+  unsigned int seed = 2;
+  int found = 0;
+  auto start = chrono::steady_clock::now();
+  for (int i = 0; i < queries; ++i) {
+    int probe = 1 + next_random(seed) % (2 * size);
+    auto it = list.begin();
+    while (it != list.end() && *it < probe) {
+      ++it;
+    }
+    if (it != list.end() && *it == probe) {
+      found++;
+    }
+  }
+  double ns = elapsed_ms(start) * 1.0e6 / queries;
+  if (found > queries) {
+    cout << found;
+  }
+  return ns;
+}
+
+// Insert odd values, which are never already in the list, at random positions,
+// then erase them again so that the list is left as it was.
+double insert_ns(Heap_list_t& list, int size, int inserts)
+{
+  unsigned int seed = 3;
+  double total_ms = 0.;
+  for (int i = 0; i < inserts; ++i) {
+    int value = 1 + 2 * (next_random(seed) % size);
+    auto start = chrono::steady_clock::now();
+    list.insert(value);
+    total_ms += elapsed_ms(start);
+  }
+  seed = 3;
+  for (int i = 0; i < inserts; ++i) {
+    auto it = list.find(1 + 2 * (next_random(seed) % size));
+    if (it != list.end()) {
+      list.erase(it);
+    }
+  }
+  return total_ms * 1.0e6 / inserts;
+}
+
+// Put the pointers in a random order, with a Fisher-Yates shuffle.
+void shuffle(int** item_ptrs, int size, unsigned int seed)
+{
+  for (int i = size - 1; i > 0; i--) {
+    int j = next_random(seed) % (i + 1);
+    int* temp_ptr = item_ptrs[i];
+    item_ptrs[i] = item_ptrs[j];
+    item_ptrs[j] = temp_ptr;
+  }
+}
+
+// Walk the list with apply, adding up the pointed-to values, as the p2 commands
+// that print or save a list do.
+template<typename L>
+double traverse_ns(const L& list, int repetitions)
+{
+  long sum = 0;
+  auto start = chrono::steady_clock::now();
+  for (int i = 0; i < repetitions; ++i) {
+    apply_arg_ref(list.begin(), list.end(), add_pointed_to, sum);
+  }
+  double ns = elapsed_ms(start) * 1.0e6 / (double(repetitions) * list.size());
+  // use the result so that the traversals can't be optimized away
+  if (sum < 0) {
+    cout << sum;
+  }
+  return ns;
+}
+
+void add_pointed_to(int* item_ptr, long& sum)
+{
+  sum += *item_ptr;
+}
+
+// Look up random values between 0 and 2 * size, half of which are in the list.
+template<typename L>
+double pointer_find_ns(const L& list, int size, int queries)
+{
+  unsigned int seed = 2;
+  int found = 0;
+  int probe_value;
+  auto start = chrono::steady_clock::now();
+  for (int i = 0; i < queries; ++i) {
+    probe_value = next_random(seed) % (2 * size);
+    if (list.find(&probe_value) != list.end()) {
+      found++;
+    }
+  }
+  double ns = elapsed_ms(start) * 1.0e6 / queries;
+  if (found > queries) {
+    cout << found;
+  }
+  return ns;
+}
@@ -77,6 +77,12 @@ public:
   // This operator defines the order relation between Records, based just on the title.
   bool operator< (const Record& rhs) const
 		{return title < rhs.title;}
+  // These compare a Record with a title, so that a title can be used directly as
+  // the key to find a Record in a container ordered by title, without a probe Record.
+  friend bool operator< (const Record& lhs, const String& rhs_title)
+		{return lhs.title < rhs_title;}
+  friend bool operator< (const String& lhs_title, const Record& rhs)
+		{return lhs_title < rhs.title;}
 
   /* *** fill in a friend declaration for the output operator */
   friend std::ostream& operator<< (std::ostream& os, const Record& record);
@@ -25,10 +25,12 @@ bool String::messages_wanted = false;
 // Default initialization is to contain an empty string with no allocation.
 // If a non-empty C-string is supplied, this String gets minimum allocation.
 String::String(const char* cstr_) {
-  if (messages_wanted) {
+  if (instrument_tracing && messages_wanted) {
     cout << "Ctor: \"" << cstr_ << "\"" << endl;
   }
-  ++number;
+  if (instrument_counters) {
+    ++number;
+  }
   internal_c_str = &a_null_byte;
   allocation = 0;
   length = 0;
@@ -44,10 +46,13 @@ String::String(const char* cstr_) {
 // The copy constructor initializes this String with the original's data,
 // and gets minimum allocation.
 String::String(const String& original) {
-  if (messages_wanted) {
+  if (instrument_tracing && messages_wanted) {
     cout << "Copy ctor: \"" << original << "\"" << endl;
   }
-  ++number;
+  P2_TRACE_EVENT(STRING_COPY_CONSTRUCT);
+  if (instrument_counters) {
+    ++number;
+  }
   allocation = original.length + 1;
   internal_c_str = allocate(allocation);
   strcpy(internal_c_str, original.internal_c_str);
@@ -58,10 +63,13 @@ String::String(const String& original) {
 // member variables to the empty state (don't initialize "this" String and swap).
 // Note: Should use move for non-primitive types in initializer's list
 String::String(String&& original) noexcept {
-  if (messages_wanted) {
+  if (instrument_tracing && messages_wanted) {
     cout << "Move ctor: \"" << original << "\"" << endl;
   }
-  ++number;
+  P2_TRACE_EVENT(STRING_MOVE_CONSTRUCT);
+  if (instrument_counters) {
+    ++number;
+  }
   swap(original);
   original.internal_c_str = &a_null_byte;
   original.allocation = 0;
@@ -71,14 +79,16 @@ String::String(String&& original) noexcept {
 // deallocate C-string memory, noexcept means won't thrown exception
 // Recall: Write destructor if object holds any resources(memory, handles etc)
 String::~String() noexcept {
-  if (messages_wanted) {
+  if (instrument_tracing && messages_wanted) {
     cout << "Dtor: \"";
     if (allocation > 0) {
       cout << internal_c_str;
     }
     cout << "\"" << endl;
   }
-  --number;
+  if (instrument_counters) {
+    --number;
+  }
   deallocate();
 }
     
@@ -88,9 +98,10 @@ String::~String() noexcept {
     
 // Copy swap is the better way for copy assignment!
 String& String::operator= (const String& rhs) {
-  if (messages_wanted) {
+  if (instrument_tracing && messages_wanted) {
     cout << "Copy assign from String:  \"" << rhs << "\"" << endl;
   }
+  P2_TRACE_EVENT(STRING_COPY_ASSIGN);
   // use copy constructor for copy assignment
   String temp(rhs);
   // swap this object's data with temp's data which was built from rhs
@@ -101,7 +112,7 @@ String& String::operator= (const String& rhs) {
 // Copy assignment - operator creates a temporary String object from the rhs
 // C-string, and swaps the contents
 String& String::operator= (const char* rhs) {
-  if (messages_wanted) {
+  if (instrument_tracing && messages_wanted) {
    cout << "Assign from C-string:  \"" << rhs << "\"" << endl;
   }
   String temp(rhs);
@@ -111,9 +122,10 @@ String& String::operator= (const char* rhs) {
 
 // Move assignment - simply swaps contents with rhs without any copying
 String& String::operator= (String&& rhs) noexcept {
-  if (messages_wanted) {
+  if (instrument_tracing && messages_wanted) {
    cout << "Move assign from String:  \"" << rhs << "\"" << endl;
   }
+  P2_TRACE_EVENT(STRING_MOVE_ASSIGN);
   swap(rhs);
   return *this;
 }
@@ -303,7 +315,9 @@ void String::grow_by_n_char(int n) {
     
 void String::deallocate() {
   if (internal_c_str && internal_c_str != &a_null_byte) {
-    total_allocation -= allocation;
+    if (instrument_counters) {
+      total_allocation -= allocation;
+    }
     delete[] internal_c_str;
   }
   allocation = 0;
@@ -312,7 +326,9 @@ void String::deallocate() {
 }
     
 char* String::allocate(int n) {
-  total_allocation += n;
+  if (instrument_counters) {
+    total_allocation += n;
+  }
   char* new_str = new char[n];
   memset(new_str, '\0', n);
   return new_str;
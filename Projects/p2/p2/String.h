@@ -9,6 +9,7 @@
 #ifndef STRING_H
 #define STRING_H
 
+#include "Instrumentation.h"
 #include <iostream>
 
 /*
@@ -55,7 +56,10 @@
  
  For testing and demonstration purposes, this class contains static 
  members that record the current number of Strings in existence and 
- their total memory allocation. If the messages_wanted variable is 
+ their total memory allocation. They are only kept up to date if the 
+ instrumentation level chosen in Instrumentation.h includes counters 
+ (the default); with P2_INSTRUMENT_NONE they always read zero. If the 
+ level is P2_INSTRUMENT_TRACING and the messages_wanted variable is 
  true, the constructors, destructor, and assignment operators output 
  a message to demonstrate when these functions are called. The 
  message is output before the function does the actual work.  
@@ -176,6 +180,7 @@ public:
 		{return total_allocation;}
   // Call with true to cause ctor, assignment, and dtor messages to be output.
   // These messages are output from each function before it does anything else.
+  // They are only compiled in at the P2_INSTRUMENT_TRACING level.
   static void set_messages_wanted(bool messages_wanted_)
 		{messages_wanted = messages_wanted_;}
   
@@ -2,6 +2,7 @@
 // NOTICE: See instructions with sample output below
 
 #include "String.h"
+#include "Instrumentation.h"
 #include <iostream>
 
 using namespace std;
@@ -120,6 +121,10 @@ int main ()
     cout << "a now has \"" << a << "\", b has \"" << b << "\"" << endl;
     print_String_info();
   }
+  
+  // where the copies and moves above were made from; this goes to cerr so that
+  // the output above stays as shown below
+  print_trace_histograms(cerr);
 }
 
 
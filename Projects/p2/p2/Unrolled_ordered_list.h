@@ -0,0 +1,679 @@
+//
+//  Unrolled_ordered_list.h
+//  Project2
+//
+/* Unrolled_ordered_list is an alternative to Ordered_list with the same interface:
+ the same ordering function objects, insert, find, erase, Iterators and
+ const_Iterators, begin and end, copy and move, emplace and try_emplace,
+ find with a key when the ordering function object is transparent,
+ insert_sorted_range and merge; and the apply function templates in
+ Ordered_list.h work with its iterators.
+ A program can switch between the two by changing a typedef.
+
+ The difference is in the layout. An Ordered_list node holds one item plus its
+ links, so a list of pointers spends most of its memory on links, and walking
+ the list touches a new node, usually in a new cache line, for every item.
+ An Unrolled_ordered_list is a doubly linked list of chunks, each of which holds
+ a small sorted array of up to N items, by default as many as fit in a 64-byte
+ cache line (but at least 4). Traversal goes along each array before following
+ a link, and there is one pair of links per chunk instead of per item.
+
+ Within the list the chunks are in order, and so are the items within each chunk.
+ find and insert step along the chunks comparing only with the last item of each,
+ and then do a binary search in the chunk that could hold the item; they take
+ O(n / N + log N) comparisons, so unlike Ordered_list, which has express lanes,
+ they are linear in the number of chunks. Inserting into a full chunk splits it in
+ two, except that a new largest item starts a new chunk, so that a list built in
+ order has full chunks. Erasing from a chunk that becomes less than a quarter
+ full moves the items of the next chunk into it if they fit, and an empty chunk
+ is removed.
+
+ Unlike Ordered_list, inserting or erasing an item moves other items within
+ their chunk, so ALL iterators into the list must be considered invalid after an
+ insert or erase, not just an iterator to the erased item. The type T must have
+ a move constructor and move assignment that do not throw, which are used for
+ these shifts; the copy of a new item is made before the list is modified, so
+ insert still provides the strong exception guarantee.
+
+ All Unrolled_ordered_list constructors and the destructor increment/decrement
+ g_Ordered_list_count, and each chunk is counted in g_Ordered_list_Node_count, at
+ the instrumentation levels that include counters. Copies, moves, and insertions
+ are traced as they are for Ordered_list.
+ */
+#ifndef UNROLLED_ORDERED_LIST_H
+#define UNROLLED_ORDERED_LIST_H
+#include "Ordered_list.h"
+#include "p2_globals.h"
+#include "Instrumentation.h"
+#include <utility>
+#include <new>
+#include <type_traits>
+#include <cassert>
+// T is the type of the objects in the list, OF the ordering function object type
+// as for Ordered_list, and N the largest number of items kept in one chunk.
+template<typename T, typename OF = Less_than_ref<T>,
+int N = (64 / sizeof(T) > 4 ? int(64 / sizeof(T)) : 4)>
+class Unrolled_ordered_list {
+  static_assert(N >= 2, "a chunk must hold at least two items");
+public:
+  // Default constructor creates an empty container.
+  Unrolled_ordered_list();
+
+  // Copy construct this list from another list by copying its data, chunk by chunk.
+  // The basic exception guarantee: if copying an item throws, the chunks already
+  // made are destroyed, and the exception is propagated from this constructor.
+  Unrolled_ordered_list(const Unrolled_ordered_list& original);
+
+  // Move construct this list by taking the chunks of the original,
+  // leaving it empty; the no-throw guarantee is made.
+  Unrolled_ordered_list(Unrolled_ordered_list&& original) noexcept;
+
+  // Copy assign using the copy-swap idiom; the strong guarantee is made.
+  Unrolled_ordered_list& operator= (const Unrolled_ordered_list& rhs);
+
+  // Move assignment swaps the current content with the rhs; no-throw guarantee.
+  Unrolled_ordered_list& operator= (Unrolled_ordered_list&& rhs) noexcept;
+
+  // destroy all the items and chunks in this list
+  ~Unrolled_ordered_list();
+
+  // Destroy the items and chunks in the list, if any, and leave it empty.
+  void clear() noexcept;
+
+  // Return the number of items in the list
+  int size() const {
+    return num_items;
+  }
+  // Return true if the list is empty
+  bool empty() const {
+    return !num_items;
+  }
+private:
+  // Chunk holds up to N items in order in raw storage; only the first count of
+  // the slots contain constructed items.
+  struct Chunk {
+    Chunk(Chunk* new_prev, Chunk* new_next) :
+    prev(new_prev), next(new_next), count(0)
+    {if (instrument_counters) {g_Ordered_list_Node_count++;}}
+    ~Chunk()
+    {if (instrument_counters) {g_Ordered_list_Node_count--;}}
+    Chunk(const Chunk&) = delete;
+    Chunk& operator= (const Chunk&) = delete;
+
+    T* items()
+		{return reinterpret_cast<T*>(slots);}
+    const T* items() const
+		{return reinterpret_cast<const T*>(slots);}
+    Chunk* prev;
+    Chunk* next;
+    int count;
+    typename std::aligned_storage<sizeof(T), alignof(T)>::type slots[N];
+  };
+
+public:
+  // An Iterator designates an item by its chunk and its index in the chunk;
+  // the end iterator has no chunk.
+  class Iterator {
+		public:
+    // default initialize to nullptr
+    Iterator() : chunk_ptr(nullptr), index(0) {}
+
+    // The * operator returns a reference to the datum in the designated slot.
+    T& operator* () const {
+      assert(chunk_ptr);
+      return chunk_ptr->items()[index];
+    }
+    // The -> operator returns the address of the datum in the designated slot.
+    T* operator-> () const {
+      assert(chunk_ptr);
+      return chunk_ptr->items() + index;
+    }
+    // Prefix ++ operator moves to the next item, which may be in the next chunk,
+    // and returns this iterator.
+    Iterator& operator++ () {
+      assert(chunk_ptr);
+      if (++index == chunk_ptr->count) {
+        chunk_ptr = chunk_ptr->next;
+        index = 0;
+      }
+      return *this;
+    }
+    // Postfix ++ operator moves to the next item, and returns an iterator
+    // designating the item it designated before.
+    Iterator operator++ (int) {
+      Iterator saved(*this);
+      ++(*this);
+      return saved;
+    }
+    // Iterators are equal if they designate the same slot
+    bool operator== (Iterator rhs) const {
+      return chunk_ptr == rhs.chunk_ptr && index == rhs.index;
+    }
+    bool operator!= (Iterator rhs) const {
+      return !(*this == rhs);
+    }
+
+    friend Unrolled_ordered_list;
+
+		private:
+    Iterator(Chunk* new_chunk_ptr, int new_index) : chunk_ptr(new_chunk_ptr), index(new_index) {}
+    Chunk* chunk_ptr;
+    int index;
+		};
+  // end of nested Iterator class declaration
+
+  // const_Iterator behaves identically to an Iterator except that it cannot be
+  // used to modify the designated datum.
+  class const_Iterator {
+		public:
+    // default initialize to nullptr
+    const_Iterator() : chunk_ptr(nullptr), index(0) {}
+
+    // A conversion constructor: construct a const_Iterator from an Iterator
+    const_Iterator(Iterator original) : chunk_ptr(original.chunk_ptr), index(original.index) {}
+
+    const T& operator* () const {
+      assert(chunk_ptr);
+      return chunk_ptr->items()[index];
+    }
+    const T* operator-> () const {
+      assert(chunk_ptr);
+      return chunk_ptr->items() + index;
+    }
+    const_Iterator& operator++ () {
+      assert(chunk_ptr);
+      if (++index == chunk_ptr->count) {
+        chunk_ptr = chunk_ptr->next;
+        index = 0;
+      }
+      return *this;
+    }
+    const_Iterator operator++ (int) {
+      const_Iterator saved(*this);
+      ++(*this);
+      return saved;
+    }
+    bool operator== (const_Iterator rhs) const
+				{return chunk_ptr == rhs.chunk_ptr && index == rhs.index;}
+    bool operator!= (const_Iterator rhs) const
+				{return !(*this == rhs);}
+
+    friend Unrolled_ordered_list;
+
+		private:
+    const_Iterator(const Chunk* new_chunk_ptr, int new_index) :
+    chunk_ptr(new_chunk_ptr), index(new_index) {}
+    const Chunk* chunk_ptr;
+    int index;
+		};
+  // end of nested const_Iterator class declaration
+
+  /* Supply begin and end iterators for a non-const container */
+  Iterator begin()
+		{return Iterator(first, 0);}
+  Iterator end()
+		{return Iterator(nullptr, 0);}
+  const_Iterator cbegin()
+		{return const_Iterator(first, 0);}
+  const_Iterator cend()
+		{return const_Iterator(nullptr, 0);}
+
+  /* Supply begin and end iterators for a const container */
+  const_Iterator begin() const
+		{return const_Iterator(first, 0);}
+  const_Iterator end() const
+		{return const_Iterator(nullptr, 0);}
+  const_Iterator cbegin() const
+		{return const_Iterator(first, 0);}
+  const_Iterator cend() const
+		{return const_Iterator(nullptr, 0);}
+
+  // The insert functions add the new datum to the list using the ordering function.
+  // If an "equal" datum is already in the list, then the list is not modified
+  // and false is returned. Otherwise, the new datum is inserted, and true is returned.
+  // The strong exception guarantee is made.
+  bool insert(const T& new_datum);
+  // This version of insert moves the datum into the list instead of copying it.
+  bool insert(T&& new_datum);
+  
+  // Construct a new datum from the supplied arguments and insert it as insert does.
+  // Since the items in a chunk move around, the datum is constructed first and
+  // then moved into its slot, rather than being constructed in place.
+  template<typename... Args>
+  bool emplace(Args&&... args);
+  // Only if no datum matching the key is in the list, construct a new datum from
+  // the supplied arguments, insert it, and return true; otherwise nothing is
+  // constructed and false is returned. The new datum must be equal to the key.
+  template<typename K, typename... Args>
+  bool try_emplace(const K& key, Args&&... args);
+
+  // Insert copies of the items in the range [first_it, last_it), which should be
+  // in order according to the ordering function. Each search starts from the chunk
+  // of the previous insertion instead of the front of the list, so the whole range
+  // is merged in a single pass. Matching items are skipped, and an item that is
+  // out of order starts the search over from the front. Returns the number of
+  // items inserted. The basic exception guarantee is made.
+  template<typename IT>
+  int insert_sorted_range(IT first_it, IT last_it);
+
+  // Move all of the items of the other list into this one in a single merging pass,
+  // leaving the other empty; items matching one already in this list are discarded.
+  // If this list is empty, the chunks are simply taken over, and nothing can throw.
+  // Otherwise the items are moved into this list's chunks, which may have to
+  // allocate, so only the basic exception guarantee is made.
+  void merge(Unrolled_ordered_list&& other);
+
+  // The find function returns an iterator designating the datum that according
+  // to the ordering function is equal to the supplied probe_datum; end() is
+  // returned if there is none.
+  Iterator find(const T& probe_datum) noexcept;
+  // The const version of find returns a const_Iterator
+  const_Iterator find(const T& probe_datum) const noexcept;
+  // If the ordering function object is transparent, find also accepts a key of
+  // any type that the ordering function object can compare with a T.
+  template<typename K, typename O = OF, typename = typename O::is_transparent>
+  Iterator find(const K& probe_key) noexcept
+		{return find_item<Iterator>(probe_key);}
+  template<typename K, typename O = OF, typename = typename O::is_transparent>
+  const_Iterator find(const K& probe_key) const noexcept
+		{return find_item<const_Iterator>(probe_key);}
+
+  // Erase the designated datum. All iterators into the list are invalid afterwards.
+  // The results are undefined if the iterator does not designate an item in this list.
+  void erase(const_Iterator it) noexcept;
+
+  // Interchange the contents of this list with the other list; no-throw guarantee.
+  void swap(Unrolled_ordered_list& other) noexcept;
+
+private:
+  OF ordering_fobj;
+  Chunk* first;
+  Chunk* last;
+  int num_items;
+
+  // Return the chunk that should hold the datum, searching from start_ptr, which
+  // must not be after that chunk: the first chunk whose last item is not less
+  // than the datum, or the last chunk if there is none; nullptr if the list is empty.
+  // The datum may also be a key the ordering function object can compare with a T.
+  template<typename K>
+  Chunk* locate_chunk(const K& datum, Chunk* start_ptr) const noexcept;
+  // Return the index of the first item in the chunk that is not less than the datum.
+  template<typename K>
+  int lower_bound(const Chunk* chunk_ptr, const K& datum) const noexcept;
+  // Return an iterator of type I designating the item matching the probe, or end().
+  template<typename I, typename K>
+  I find_item(const K& probe_datum) const noexcept;
+  // Insert the datum, searching from start_ptr as in locate_chunk; return the chunk
+  // now holding the datum, or nullptr if a matching item was already there.
+  // new_datum is only moved from once the list has room for it, so nothing
+  // has changed if an exception is thrown.
+  Chunk* insert_from(T&& new_datum, Chunk* start_ptr);
+  // Make a new empty chunk linked in after the supplied chunk, or as the only
+  // chunk if the supplied one is nullptr.
+  Chunk* add_chunk_after(Chunk* chunk_ptr);
+  // Unlink and destroy an empty chunk.
+  void remove_chunk(Chunk* chunk_ptr) noexcept;
+};
+
+// Default constructor creates an empty container.
+template<typename T, typename OF, int N>
+Unrolled_ordered_list<T, OF, N>::Unrolled_ordered_list()
+: first(nullptr), last(nullptr), num_items(0) {
+  if (instrument_counters) {
+    g_Ordered_list_count++;
+  }
+}
+// Copy construct this list from another list by copying its data, chunk by chunk.
+template<typename T, typename OF, int N>
+Unrolled_ordered_list<T, OF, N>::Unrolled_ordered_list(const Unrolled_ordered_list& original)
+: first(nullptr), last(nullptr), num_items(0)
+{
+  P2_TRACE_EVENT(LIST_COPY_CONSTRUCT);
+  try {
+    for (const Chunk* copy_chunk_ptr = original.first; copy_chunk_ptr;
+         copy_chunk_ptr = copy_chunk_ptr->next) {
+      Chunk* chunk_ptr = add_chunk_after(last);
+      for (int i = 0; i < copy_chunk_ptr->count; i++) {
+        new (chunk_ptr->items() + i) T(copy_chunk_ptr->items()[i]);
+        chunk_ptr->count++;
+        num_items++;
+      }
+    }
+  } catch(...) {
+    clear();
+    throw;
+  }
+  // counted only once constructed, since the destructor won't run if the copy throws
+  if (instrument_counters) {
+    g_Ordered_list_count++;
+  }
+}
+// Move construct this list by taking the chunks of the original.
+template<typename T, typename OF, int N>
+Unrolled_ordered_list<T, OF, N>::Unrolled_ordered_list(Unrolled_ordered_list&& original) noexcept
+: first(original.first), last(original.last), num_items(original.num_items)
+{
+  P2_TRACE_EVENT(LIST_MOVE_CONSTRUCT);
+  original.first = original.last = nullptr;
+  original.num_items = 0;
+  if (instrument_counters) {
+    g_Ordered_list_count++;
+  }
+}
+// Copy assign using the copy-swap idiom.
+template<typename T, typename OF, int N>
+Unrolled_ordered_list<T, OF, N>& Unrolled_ordered_list<T, OF, N>::operator= (const Unrolled_ordered_list& rhs)
+{
+  P2_TRACE_EVENT(LIST_COPY_ASSIGN);
+  Unrolled_ordered_list<T, OF, N> temp_list(rhs);
+  swap(temp_list);
+  return *this;
+}
+// Move assignment swaps the current content with the rhs.
+template<typename T, typename OF, int N>
+Unrolled_ordered_list<T, OF, N>& Unrolled_ordered_list<T, OF, N>::operator= (Unrolled_ordered_list&& rhs) noexcept
+{
+  P2_TRACE_EVENT(LIST_MOVE_ASSIGN);
+  swap(rhs);
+  return *this;
+}
+// destroy all the items and chunks in this list
+template<typename T, typename OF, int N>
+Unrolled_ordered_list<T, OF, N>::~Unrolled_ordered_list() {
+  if (instrument_counters) {
+    g_Ordered_list_count--;
+  }
+  clear();
+}
+// Destroy the items and chunks in the list, if any, and leave it empty.
+template<typename T, typename OF, int N>
+void Unrolled_ordered_list<T, OF, N>::clear() noexcept {
+  Chunk* chunk_ptr = first;
+  while (chunk_ptr) {
+    Chunk* next_chunk_ptr = chunk_ptr->next;
+    for (int i = 0; i < chunk_ptr->count; i++) {
+      chunk_ptr->items()[i].~T();
+    }
+    delete chunk_ptr;
+    chunk_ptr = next_chunk_ptr;
+  }
+  first = last = nullptr;
+  num_items = 0;
+}
+// The insert functions add the new datum to the list using the ordering function.
+// A copy of the datum is made first, so that the list is unchanged if copying throws.
+template<typename T, typename OF, int N>
+bool Unrolled_ordered_list<T, OF, N>::insert(const T& new_datum) {
+  P2_TRACE_EVENT(LIST_INSERT_COPY);
+  Chunk* chunk_ptr = locate_chunk(new_datum, first);
+  if (chunk_ptr) {
+    int index = lower_bound(chunk_ptr, new_datum);
+    // data already exist
+    if (index < chunk_ptr->count &&
+        !ordering_fobj(new_datum, chunk_ptr->items()[index])) {
+      return false;
+    }
+  }
+  T new_datum_copy(new_datum);
+  return insert_from(std::move(new_datum_copy), chunk_ptr) != nullptr;
+}
+// This version of insert moves the datum into the list instead of copying it.
+template<typename T, typename OF, int N>
+bool Unrolled_ordered_list<T, OF, N>::insert(T&& new_datum) {
+  P2_TRACE_EVENT(LIST_INSERT_MOVE);
+  return insert_from(std::move(new_datum), first) != nullptr;
+}
+// Construct a new datum from the supplied arguments and insert it as insert does.
+template<typename T, typename OF, int N>
+template<typename... Args>
+bool Unrolled_ordered_list<T, OF, N>::emplace(Args&&... args) {
+  T new_datum(std::forward<Args>(args)...);
+  return insert_from(std::move(new_datum), first) != nullptr;
+}
+// Only if no datum matching the key is in the list, construct a new datum from
+// the supplied arguments and insert it.
+template<typename T, typename OF, int N>
+template<typename K, typename... Args>
+bool Unrolled_ordered_list<T, OF, N>::try_emplace(const K& key, Args&&... args) {
+  Chunk* chunk_ptr = locate_chunk(key, first);
+  if (chunk_ptr) {
+    int index = lower_bound(chunk_ptr, key);
+    if (index < chunk_ptr->count && !ordering_fobj(key, chunk_ptr->items()[index])) {
+      return false;
+    }
+  }
+  T new_datum(std::forward<Args>(args)...);
+  return insert_from(std::move(new_datum), chunk_ptr) != nullptr;
+}
+// Insert copies of the items in the range [first_it, last_it), searching for each
+// from the chunk of the previous insertion. Returns the number of items inserted.
+template<typename T, typename OF, int N>
+template<typename IT>
+int Unrolled_ordered_list<T, OF, N>::insert_sorted_range(IT first_it, IT last_it) {
+  Chunk* start_ptr = first;
+  int num_inserted = 0;
+  for (; first_it != last_it; ++first_it) {
+    // out of order, so start over from the front of the list
+    if (start_ptr && start_ptr->count && ordering_fobj(*first_it, start_ptr->items()[0])) {
+      start_ptr = first;
+    }
+    T new_datum(*first_it);
+    Chunk* chunk_ptr = insert_from(std::move(new_datum), start_ptr);
+    if (chunk_ptr) {
+      start_ptr = chunk_ptr;
+      num_inserted++;
+    }
+  }
+  return num_inserted;
+}
+// Move all of the items of the other list into this one in a single merging pass,
+// leaving the other empty.
+template<typename T, typename OF, int N>
+void Unrolled_ordered_list<T, OF, N>::merge(Unrolled_ordered_list&& other) {
+  if (&other == this) {
+    return;
+  }
+  if (empty()) {
+    swap(other);
+    other.clear();
+    return;
+  }
+  Chunk* start_ptr = first;
+  for (Chunk* chunk_ptr = other.first; chunk_ptr; chunk_ptr = chunk_ptr->next) {
+    for (int i = 0; i < chunk_ptr->count; i++) {
+      Chunk* inserted_in_ptr = insert_from(std::move(chunk_ptr->items()[i]), start_ptr);
+      if (inserted_in_ptr) {
+        start_ptr = inserted_in_ptr;
+      }
+    }
+  }
+  other.clear();
+}
+// The find function returns an iterator designating the datum that according
+// to the ordering function is equal to the supplied probe_datum.
+template<typename T, typename OF, int N>
+typename Unrolled_ordered_list<T, OF, N>::Iterator
+Unrolled_ordered_list<T, OF, N>::find(const T& probe_datum) noexcept {
+  return find_item<Iterator>(probe_datum);
+}
+// The const version of find returns a const_Iterator
+template<typename T, typename OF, int N>
+typename Unrolled_ordered_list<T, OF, N>::const_Iterator
+Unrolled_ordered_list<T, OF, N>::find(const T& probe_datum) const noexcept {
+  return find_item<const_Iterator>(probe_datum);
+}
+// Erase the designated datum, closing up the gap in its chunk. A chunk left less
+// than a quarter full takes over the items of the next chunk if they fit,
+// and an empty chunk is removed.
+template<typename T, typename OF, int N>
+void Unrolled_ordered_list<T, OF, N>::erase(const_Iterator it) noexcept {
+  assert(it.chunk_ptr);
+  // the iterator only designates the chunk, which belongs to this list
+  Chunk* chunk_ptr = const_cast<Chunk*>(it.chunk_ptr);
+  T* items = chunk_ptr->items();
+  for (int i = it.index; i < chunk_ptr->count - 1; i++) {
+    items[i] = std::move(items[i + 1]);
+  }
+  items[chunk_ptr->count - 1].~T();
+  chunk_ptr->count--;
+  num_items--;
+  if (!chunk_ptr->count) {
+    remove_chunk(chunk_ptr);
+    return;
+  }
+  Chunk* next_chunk_ptr = chunk_ptr->next;
+  if (chunk_ptr->count < N / 4 && next_chunk_ptr &&
+      chunk_ptr->count + next_chunk_ptr->count <= N) {
+    T* next_items = next_chunk_ptr->items();
+    for (int i = 0; i < next_chunk_ptr->count; i++) {
+      new (items + chunk_ptr->count) T(std::move(next_items[i]));
+      chunk_ptr->count++;
+      next_items[i].~T();
+    }
+    next_chunk_ptr->count = 0;
+    remove_chunk(next_chunk_ptr);
+  }
+}
+// Interchange the contents of this list with the other list.
+template<typename T, typename OF, int N>
+void Unrolled_ordered_list<T, OF, N>::swap(Unrolled_ordered_list& other) noexcept {
+  std::swap(first, other.first);
+  std::swap(last, other.last);
+  std::swap(num_items, other.num_items);
+}
+// private helpers
+// Return the chunk that should hold the datum, searching from start_ptr: the first
+// chunk whose last item is not less than the datum, or the last chunk if there is none.
+template<typename T, typename OF, int N>
+template<typename K>
+typename Unrolled_ordered_list<T, OF, N>::Chunk*
+Unrolled_ordered_list<T, OF, N>::locate_chunk(const K& datum, Chunk* start_ptr) const noexcept {
+  Chunk* chunk_ptr = start_ptr;
+  while (chunk_ptr && chunk_ptr->next &&
+         ordering_fobj(chunk_ptr->items()[chunk_ptr->count - 1], datum)) {
+    chunk_ptr = chunk_ptr->next;
+  }
+  return chunk_ptr;
+}
+// Return the index of the first item in the chunk that is not less than the datum.
+template<typename T, typename OF, int N>
+template<typename K>
+int Unrolled_ordered_list<T, OF, N>::lower_bound(const Chunk* chunk_ptr,
+                                                 const K& datum) const noexcept {
+  int low = 0;
+  int high = chunk_ptr->count;
+  while (low < high) {
+    int middle = (low + high) / 2;
+    if (ordering_fobj(chunk_ptr->items()[middle], datum)) {
+      low = middle + 1;
+    }
+    else {
+      high = middle;
+    }
+  }
+  return low;
+}
+// Return an iterator of type I designating the item matching the probe, or end().
+template<typename T, typename OF, int N>
+template<typename I, typename K>
+I Unrolled_ordered_list<T, OF, N>::find_item(const K& probe_datum) const noexcept {
+  Chunk* chunk_ptr = locate_chunk(probe_datum, first);
+  if (chunk_ptr) {
+    int index = lower_bound(chunk_ptr, probe_datum);
+    if (index < chunk_ptr->count && !ordering_fobj(probe_datum, chunk_ptr->items()[index])) {
+      return I(chunk_ptr, index);
+    }
+  }
+  return I(nullptr, 0);
+}
+// Insert the datum, searching from start_ptr; return the chunk now holding the
+// datum, or nullptr if a matching item was already there.
+template<typename T, typename OF, int N>
+typename Unrolled_ordered_list<T, OF, N>::Chunk*
+Unrolled_ordered_list<T, OF, N>::insert_from(T&& new_datum, Chunk* start_ptr) {
+  Chunk* chunk_ptr = locate_chunk(new_datum, start_ptr);
+  if (!chunk_ptr) {
+    chunk_ptr = add_chunk_after(nullptr);
+  }
+  int index = lower_bound(chunk_ptr, new_datum);
+  if (index < chunk_ptr->count && !ordering_fobj(new_datum, chunk_ptr->items()[index])) {
+    return nullptr;
+  }
+  if (chunk_ptr->count == N) {
+    Chunk* new_chunk_ptr = add_chunk_after(chunk_ptr);
+    if (index == N) {
+      // a new largest item starts a new chunk, so that a list built in order is packed
+      chunk_ptr = new_chunk_ptr;
+      index = 0;
+    }
+    else {
+      // split the full chunk in two, and insert into whichever half the datum belongs in
+      int num_kept = N / 2;
+      T* items = chunk_ptr->items();
+      for (int i = num_kept; i < N; i++) {
+        new (new_chunk_ptr->items() + (i - num_kept)) T(std::move(items[i]));
+        items[i].~T();
+      }
+      new_chunk_ptr->count = N - num_kept;
+      chunk_ptr->count = num_kept;
+      if (index > num_kept) {
+        chunk_ptr = new_chunk_ptr;
+        index -= num_kept;
+      }
+    }
+  }
+  // open a gap at index by moving the items after it up one slot
+  T* items = chunk_ptr->items();
+  int count = chunk_ptr->count;
+  if (index == count) {
+    new (items + count) T(std::move(new_datum));
+  }
+  else {
+    new (items + count) T(std::move(items[count - 1]));
+    for (int i = count - 1; i > index; i--) {
+      items[i] = std::move(items[i - 1]);
+    }
+    items[index] = std::move(new_datum);
+  }
+  chunk_ptr->count++;
+  num_items++;
+  return chunk_ptr;
+}
+// Make a new empty chunk linked in after the supplied chunk, or as the only chunk.
+template<typename T, typename OF, int N>
+typename Unrolled_ordered_list<T, OF, N>::Chunk*
+Unrolled_ordered_list<T, OF, N>::add_chunk_after(Chunk* chunk_ptr) {
+  Chunk* new_chunk_ptr = new Chunk(chunk_ptr, chunk_ptr ? chunk_ptr->next : nullptr);
+  if (new_chunk_ptr->next) {
+    new_chunk_ptr->next->prev = new_chunk_ptr;
+  }
+  else {
+    last = new_chunk_ptr;
+  }
+  if (chunk_ptr) {
+    chunk_ptr->next = new_chunk_ptr;
+  }
+  else {
+    first = new_chunk_ptr;
+  }
+  return new_chunk_ptr;
+}
+// Unlink and destroy an empty chunk.
+template<typename T, typename OF, int N>
+void Unrolled_ordered_list<T, OF, N>::remove_chunk(Chunk* chunk_ptr) noexcept {
+  assert(!chunk_ptr->count);
+  if (chunk_ptr->next) {
+    chunk_ptr->next->prev = chunk_ptr->prev;
+  }
+  else {
+    last = chunk_ptr->prev;
+  }
+  if (chunk_ptr->prev) {
+    chunk_ptr->prev->next = chunk_ptr->next;
+  }
+  else {
+    first = chunk_ptr->next;
+  }
+  delete chunk_ptr;
+}
+#endif
@@ -14,6 +14,7 @@
 #include <iostream>
 #include <fstream>
 #include <new> // bad alloc
+#include <vector>
 using namespace std;
 
 /* Note: Good function tree, fundamental programming technique for
@@ -24,14 +25,20 @@ using namespace std;
  implemented by calling a set of helper functions. Reuse helper
  functions across commands if possible.
  */
+// Order Records by ID; it is transparent, so an ID can be used as the key to find a Record.
 struct Record_ID_comp {
+  typedef void is_transparent;
   bool operator() (const Record *lhs, const Record *rhs) const {
     return lhs->get_ID() < rhs->get_ID(); }
+  bool operator() (const Record *lhs, int rhs_ID) const {
+    return lhs->get_ID() < rhs_ID; }
+  bool operator() (int lhs_ID, const Record *rhs) const {
+    return lhs_ID < rhs->get_ID(); }
 };
 
-typedef Ordered_list<Collection*, Less_than_ptr<Collection*>> Catalog_t;
-typedef Ordered_list<Record*, Less_than_ptr<Record*>> Library_title_t;
-typedef Ordered_list<Record*, Record_ID_comp> Library_id_t;
+typedef Ordered_container<Collection*, Less_than_ptr<Collection*>> Catalog_t;
+typedef Ordered_container<Record*, Less_than_ptr<Record*>> Library_title_t;
+typedef Ordered_container<Record*, Record_ID_comp> Library_id_t;
 
 static void find_record(Library_title_t& library_title);
 static void print_record(Library_id_t& library_id);
@@ -288,8 +295,7 @@ static void add_record(Library_title_t& library_title, Library_id_t& library_id)
   String medium, title;
   cin >> medium;
   read_and_compact_title(cin, title);
-  Record rec(title);
-  if (library_title.find(&rec) != library_title.end()) {
+  if (library_title.find(title) != library_title.end()) {
     throw Error("Library already has a record with this title!");
   }
   Record* rec_ptr = new Record(Record::ID_counter, medium, title);
@@ -301,8 +307,7 @@ static void add_record(Library_title_t& library_title, Library_id_t& library_id)
 static void add_collection(Catalog_t& catalog) {
   String name;
   cin >> name;
-  Collection collection(name);
-  if (catalog.find(&collection) != catalog.end()) {
+  if (catalog.find(name) != catalog.end()) {
     throw Error("Catalog already has a collection with this name!");
   }
   catalog.insert(new Collection(name));
@@ -337,8 +342,7 @@ static void delete_record(Library_title_t& library_title, Library_id_t& library_
       throw Error("Cannot delete a record that is a member of a collection!");
     }
   }
-  Record rec((*title_iter)->get_ID());
-  auto id_iter = library_id.find(&rec);
+  auto id_iter = library_id.find(rec_ptr->get_ID());
   cout << "Record "<< (*id_iter)->get_ID() << " " << (*id_iter)->get_title() <<
   " deleted" << endl;
   library_title.erase(title_iter);
@@ -429,12 +433,19 @@ static void restore_all_data(Library_title_t& library_title, Library_id_t& libra
   Catalog_t new_catalog;
   Library_title_t new_library_title;
   Library_id_t new_library_id;
+  // the records were saved in title order, so they are read into a vector
+  // and then merged into the title library in a single pass; the vector grows
+  // as the records are read, so a bad count in the file can't make it huge
+  std::vector<Record*> record_ptrs;
   try {
     Record::save_ID_counter();
     Record::reset_ID_counter();
     for (int i = 0; i < num ; i++) {
-      Record *rec_ptr = new Record(in_file_stream);
-      new_library_title.insert(rec_ptr);
+      record_ptrs.push_back(new Record(in_file_stream));
+    }
+    new_library_title.insert_sorted_range(record_ptrs.begin(), record_ptrs.end());
+    record_ptrs.clear();
+    for (auto rec_ptr: new_library_title) {
       new_library_id.insert(rec_ptr);
     }
     if (!(in_file_stream >> num)) {
@@ -449,13 +460,18 @@ static void restore_all_data(Library_title_t& library_title, Library_id_t& libra
     }
     clear_libraries(library_title, library_id);
     clear_catalog(catalog);
-    library_title = new_library_title;
-    library_id = new_library_id;
-    catalog = new_catalog;
+    // move the new nodes into the emptied containers without copying them
+    library_title.merge(std::move(new_library_title));
+    library_id.merge(std::move(new_library_id));
+    catalog.merge(std::move(new_catalog));
     cout << "Data loaded\n";
     in_file_stream.close();
   }
   catch (Error& err) {
+    // the records read but not yet merged are only in the vector
+    for (auto rec_ptr: record_ptrs) {
+      delete rec_ptr;
+    }
     clear_catalog(new_catalog);
     clear_libraries(new_library_title, new_library_id);
     Record::restore_ID_counter();
@@ -468,8 +484,7 @@ static void restore_all_data(Library_title_t& library_title, Library_id_t& libra
 static Library_title_t::Iterator get_record_by_title(Library_title_t& library_title) {
   String title;
   read_and_compact_title(cin, title);
-  Record rec(title);
-  auto it = library_title.find(&rec);
+  auto it = library_title.find(title);
   if (it == library_title.end()) {
     throw Error("No record with that title!");
   }
@@ -482,8 +497,7 @@ static Library_id_t::Iterator get_record_by_id(Library_id_t& library_id) {
   if (!cin) {
     throw Error("Could not read an integer value!");
   }
-  Record rec(id);
-  auto it = library_id.find(&rec);
+  auto it = library_id.find(id);
   if (it == library_id.end()) {
     throw Error("No record with that ID!");
   }
@@ -493,8 +507,7 @@ static Library_id_t::Iterator get_record_by_id(Library_id_t& library_id) {
 static Catalog_t::Iterator get_collection_by_name(Catalog_t& catalog) {
   String name;
   cin >> name;
-  Collection collection(name);
-  auto it = catalog.find(&collection);
+  auto it = catalog.find(name);
   if (it == catalog.end()) {
     throw Error("No collection with that name!");
   }
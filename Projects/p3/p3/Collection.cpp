@@ -15,6 +15,10 @@
 #include <iostream>
 using namespace std;
 
+int Collection::num_records_in_any = 0;
+int Collection::num_records_in_many = 0;
+int Collection::num_memberships = 0;
+
 /* Construct a Collection from an input file stream in save format, using the record 
  list, restoring all the Record information. Record list is needed to resolve 
  references to record members. No check made for whether the Collection already 
@@ -41,6 +45,59 @@ Collection::Collection(ifstream& is, const vector<Record*>& library) {
     }
     list_of_record_ptrs.insert(*it);
   }
+  member_IDs = make_member_IDs(list_of_record_ptrs);
+  // counted only once nothing more can throw, since the destructor won't run if
+  // the constructor throws
+  count_all_members();
+}
+
+// a copy of the members has the same IDs, so they are shared
+Collection::Collection(const string& name_, const Collection& col_) :
+list_of_record_ptrs(col_.list_of_record_ptrs), name(name_), member_IDs(col_.member_IDs) {
+  count_all_members();
+}
+
+Collection::Collection(const string& name_, const Collection& col1_,
+                       const Collection& col2_) :
+list_of_record_ptrs(col1_.list_of_record_ptrs, col2_.list_of_record_ptrs), name(name_),
+member_IDs(make_member_IDs(list_of_record_ptrs)) {
+  count_all_members();
+}
+
+Collection::Collection(const Collection& original) :
+list_of_record_ptrs(original.list_of_record_ptrs), name(original.name),
+member_IDs(original.member_IDs) {
+  count_all_members();
+}
+
+Collection::Collection(Collection&& original) noexcept :
+list_of_record_ptrs(move(original.list_of_record_ptrs)), name(move(original.name)),
+member_IDs(move(original.member_IDs)) {
+  // the members now belong to this Collection and are already counted
+  original.list_of_record_ptrs.clear();
+  original.member_IDs = no_member_IDs();
+}
+
+Collection& Collection::operator= (const Collection& rhs) {
+  // copy first, so that nothing changes if the copy fails
+  Collection copy(rhs);
+  return *this = move(copy);
+}
+
+Collection& Collection::operator= (Collection&& rhs) noexcept {
+  if (this != &rhs) {
+    uncount_all_members();
+    list_of_record_ptrs = move(rhs.list_of_record_ptrs);
+    name = move(rhs.name);
+    member_IDs = move(rhs.member_IDs);
+    rhs.list_of_record_ptrs.clear();
+    rhs.member_IDs = no_member_IDs();
+  }
+  return *this;
+}
+
+Collection::~Collection() {
+  uncount_all_members();
 }
 
 // Add the Record, throw exception if there is already a Record with the same title.
@@ -48,7 +105,14 @@ void Collection::add_member(Record* record_ptr) {
   if (is_member_present(record_ptr)) {
     throw Error("Record is already a member in the collection!");
   }
-  list_of_record_ptrs.insert(record_ptr);
+  // make room for the ID first, so that nothing can fail once the Record is inserted
+  vector<int>& IDs = writable_member_IDs();
+  if (IDs.size() == IDs.capacity()) {
+    IDs.reserve(2 * IDs.size() + 1);
+  }
+  auto it = list_of_record_ptrs.insert(record_ptr).first;
+  IDs.insert(IDs.begin() + (it - list_of_record_ptrs.begin()), record_ptr->get_ID());
+  count_membership(record_ptr);
 }
 
 // Return true if the record is present, false if not.
@@ -62,24 +126,101 @@ void Collection::remove_member(Record* record_ptr) {
   if (it == list_of_record_ptrs.end()) {
     throw Error("Record is not a member in the collection!");
   }
+  vector<int>& IDs = writable_member_IDs();
+  IDs.erase(IDs.begin() + (it - list_of_record_ptrs.begin()));
   list_of_record_ptrs.erase(it);
+  uncount_membership(record_ptr);
+}
+
+// discard all members
+void Collection::clear() {
+  uncount_all_members();
+  list_of_record_ptrs.clear();
+  member_IDs = no_member_IDs();
 }
 
-// Write a Collections's data to a stream in save format, with endl as specified.
+// Write a Collections's data to a stream in save format, with newlines as specified,
+// without flushing the stream.
 void Collection::save(ostream& os) const {
-  os << name << " " << list_of_record_ptrs.size() << endl;
+  os << name << " " << list_of_record_ptrs.size() << '\n';
   for_each(list_of_record_ptrs.begin(), list_of_record_ptrs.end(),
-           [&os](Record* rec_ptr) {os << rec_ptr->get_title() << endl;});
+           [&os](Record* rec_ptr) {os << rec_ptr->get_title() << '\n';});
   
 }
 
 // combine 2 collections to form new collection
 Collection& Collection::operator+= (const Collection& rhs) {
-  for_each(rhs.list_of_record_ptrs.begin(), rhs.list_of_record_ptrs.end(),
-  [this](Record* rec_ptr) {if (!is_member_present(rec_ptr)) {list_of_record_ptrs.insert(rec_ptr);}});
+  // room for the IDs first, so that nothing can fail once the members are merged
+  auto new_IDs = make_shared<vector<int>>();
+  new_IDs->reserve(list_of_record_ptrs.size() + rhs.list_of_record_ptrs.size());
+  // one linear merge; only the members that rhs adds need counting
+  list_of_record_ptrs.merge(rhs.list_of_record_ptrs, count_membership);
+  for (Record* record_ptr : list_of_record_ptrs) {
+    new_IDs->push_back(record_ptr->get_ID());
+  }
+  member_IDs = move(new_IDs);
   return *this;
 }
 
+// count one membership of the Record in the Record and the statistics
+void Collection::count_membership(Record* record_ptr) noexcept {
+  int& num_collections = record_ptr->num_collections;
+  if (num_collections == 0) {
+    ++num_records_in_any;
+  }
+  else if (num_collections == 1) {
+    ++num_records_in_many;
+  }
+  ++num_collections;
+  ++num_memberships;
+}
+
+// uncount one membership of the Record in the Record and the statistics
+void Collection::uncount_membership(Record* record_ptr) noexcept {
+  int& num_collections = record_ptr->num_collections;
+  --num_collections;
+  if (num_collections == 0) {
+    --num_records_in_any;
+  }
+  else if (num_collections == 1) {
+    --num_records_in_many;
+  }
+  --num_memberships;
+}
+
+void Collection::count_all_members() noexcept {
+  for (Record* record_ptr : list_of_record_ptrs) {
+    count_membership(record_ptr);
+  }
+}
+
+void Collection::uncount_all_members() noexcept {
+  for (Record* record_ptr : list_of_record_ptrs) {
+    uncount_membership(record_ptr);
+  }
+}
+
+shared_ptr<vector<int>> Collection::make_member_IDs(const Record_set_t& members) {
+  auto IDs = make_shared<vector<int>>();
+  IDs->reserve(members.size());
+  for (Record* record_ptr : members) {
+    IDs->push_back(record_ptr->get_ID());
+  }
+  return IDs;
+}
+
+const shared_ptr<vector<int>>& Collection::no_member_IDs() noexcept {
+  static const shared_ptr<vector<int>> no_IDs = make_shared<vector<int>>();
+  return no_IDs;
+}
+
+vector<int>& Collection::writable_member_IDs() {
+  if (member_IDs.use_count() > 1) {
+    member_IDs = make_shared<vector<int>>(*member_IDs);
+  }
+  return *member_IDs;
+}
+
 // Print the Collection data
 ostream& operator<< (ostream& os, const Collection& collection) {
   os << "Collection " << collection.name << " contains:";
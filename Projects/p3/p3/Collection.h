@@ -10,10 +10,11 @@
 #define COLLECTION_H
 #include "Record.h"
 #include "Utility.h"
+#include "Flat_set.h"
 #include <fstream>
+#include <memory>
 #include <ostream>
 #include <string>
-#include <set>
 #include <vector>
 
 
@@ -24,19 +25,36 @@ struct Title_less_ptr {
   }
 };
 
-typedef std::set<Record*, Title_less_ptr> Record_set_t;
+typedef Flat_set<Record*, Title_less_ptr> Record_set_t;
 
 class Collection {
   /* Collections contain a name and a container of members, represented as 
    pointers to Records. Collection objects manage their own Record container.
    The container of Records is not available to clients.
+   Every Collection object counts its members in each member Record, and in the
+   statistics over all Collections, for as long as it has them. So a copy of a
+   Collection counts as another Collection, and a Collection must be destroyed or
+   cleared before any of its member Records are deleted.
+   The IDs of the members are also kept in title order, in a vector that is shared
+   by copies of the Collection and by Data_snapshots, and copied only when a
+   Collection changes it while it is shared, as the columns of Record_columns are.
    */
 public:
   // Construct a collection with the specified name and no members
-  Collection(const std::string& name_) : name(name_) {}
+  Collection(const std::string& name_) : name(name_), member_IDs(no_member_IDs()) {}
   
-  Collection(const std::string& name_, const Collection& col_) :
-  list_of_record_ptrs(col_.list_of_record_ptrs), name(name_) {}
+  Collection(const std::string& name_, const Collection& col_);
+  // Construct a collection with the specified name whose members are those of both
+  // collections, combined in a single pass.
+  Collection(const std::string& name_, const Collection& col1_, const Collection& col2_);
+
+  // Copies count their members again; a moved-from Collection is left empty, and
+  // its members are counted only for the Collection they were moved to.
+  Collection(const Collection& original);
+  Collection(Collection&& original) noexcept;
+  Collection& operator= (const Collection& rhs);
+  Collection& operator= (Collection&& rhs) noexcept;
+  ~Collection();
 
   /* Construct a Collection from an input file stream in save format, using the 
    record list, restoring all the Record information. Record list is needed to resolve 
@@ -45,11 +63,41 @@ public:
    string data input is read directly into the member variable. */
   Collection(std::ifstream& is, const std::vector<Record*>& library);
   
+  /* A Member_view is a read-only range over the members of a Collection in title
+   order, for use in a range for or with the STL algorithms. It refers to the
+   Collection's own container rather than copying it, so it is only valid until the
+   Collection is changed or destroyed. */
+  class Member_view {
+  public:
+    typedef Record_set_t::const_iterator iterator;
+    iterator begin() const
+		{return first;}
+    iterator end() const
+		{return last;}
+    int size() const
+		{return num_members;}
+    bool empty() const
+		{return num_members == 0;}
+  private:
+    friend class Collection;
+    Member_view(iterator first_, iterator last_, int num_members_) :
+    first(first_), last(last_), num_members(num_members_) {}
+    iterator first;
+    iterator last;
+    int num_members;
+  };
+
   // Accessors
   const std::string& get_name() const
 		{return name;}
-  const Record_set_t get_list_of_record_ptrs() const
-  {return list_of_record_ptrs;}
+  // the IDs of the members in title order, shared rather than copied; the vector
+  // never changes while the pointer is held
+  std::shared_ptr<const std::vector<int>> get_member_IDs() const
+		{return member_IDs;}
+  // a view of the members, without copying them
+  Member_view get_members() const
+		{return Member_view(list_of_record_ptrs.begin(), list_of_record_ptrs.end(),
+                        int(list_of_record_ptrs.size()));}
   // Add the Record, throw exception if there is already a Record with the same title.
   void add_member(Record* record_ptr);
   // Return true if there are no members; false otherwise
@@ -60,9 +108,9 @@ public:
   // Remove the specified Record, throw exception if the record was not found.
   void remove_member(Record* record_ptr);
   // discard all members
-  void clear()
-		{list_of_record_ptrs.clear();}
-  // Write a Collections's data to a stream in save format, with endl as specified.
+  void clear();
+  // Write a Collections's data to a stream in save format, with newlines as specified,
+  // without flushing the stream.
   void save(std::ostream& os) const;
   // combine 2 collections to form new collection
   Collection& operator+= (const Collection& rhs);
@@ -76,10 +124,38 @@ public:
   {return name != rhs.name;}
   /* *** fill in a friend declaration for the output operator */
   friend std::ostream& operator<< (std::ostream& os, const Collection& collection);
+
+  // Statistics over the members of all Collections that exist, read in constant time.
+  // the number of Records that are a member of at least one Collection
+  static int get_num_records_in_any()
+		{return num_records_in_any;}
+  // the number of Records that are a member of more than one Collection
+  static int get_num_records_in_many()
+		{return num_records_in_many;}
+  // the total number of members over all Collections
+  static int get_num_memberships()
+		{return num_memberships;}
 		
 private:
   Record_set_t list_of_record_ptrs;
   std::string name;
+  std::shared_ptr<std::vector<int>> member_IDs;
+  static int num_records_in_any;
+  static int num_records_in_many;
+  static int num_memberships;
+
+  // count or uncount one membership of the Record in the Record and the statistics
+  static void count_membership(Record* record_ptr) noexcept;
+  static void uncount_membership(Record* record_ptr) noexcept;
+  // count or uncount all the members of this Collection
+  void count_all_members() noexcept;
+  void uncount_all_members() noexcept;
+  // the IDs of the members, for a newly constructed Collection
+  static std::shared_ptr<std::vector<int>> make_member_IDs(const Record_set_t& members);
+  // the IDs of no members, shared by all the Collections that have none to their own
+  static const std::shared_ptr<std::vector<int>>& no_member_IDs() noexcept;
+  // the IDs for changing, copied first if they are shared
+  std::vector<int>& writable_member_IDs();
 };
 
 // Print the Collection data
@@ -0,0 +1,38 @@
+//
+//  Data_snapshot.cpp
+//  Project3
+//
+
+#include "Data_snapshot.h"
+#include <algorithm>
+#include <numeric>
+using namespace std;
+
+Data_snapshot::Data_snapshot(const Record_columns& columns_, const vector<Collection>& catalog) :
+columns(columns_) {
+  collections.reserve(catalog.size());
+  for (const Collection& col : catalog) {
+    collections.push_back(Collection_image{col.get_name(), col.get_member_IDs()});
+  }
+}
+
+// The rows of the columns are in ID order, so they are sorted into the title order
+// of the library here, on whatever thread is saving.
+void Data_snapshot::save(ostream& os) const {
+  vector<size_t> rows(columns.size());
+  iota(rows.begin(), rows.end(), size_t(0));
+  sort(rows.begin(), rows.end(), [this](size_t lhs, size_t rhs) {
+    return columns.title_less(lhs, rhs);});
+  os << rows.size() << '\n';
+  for (size_t row : rows) {
+    columns.save_row(os, row);
+  }
+  os << collections.size() << '\n';
+  for (const Collection_image& image : collections) {
+    os << image.name << " " << image.member_IDs->size() << '\n';
+    for (int ID : *image.member_IDs) {
+      columns.write_title(os, columns.find_row(ID));
+      os << '\n';
+    }
+  }
+}
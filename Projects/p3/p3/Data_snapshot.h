@@ -0,0 +1,43 @@
+//
+//  Data_snapshot.h
+//  Project3
+//
+
+#ifndef DATA_SNAPSHOT_H
+#define DATA_SNAPSHOT_H
+#include "Record_columns.h"
+#include "Collection.h"
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
+
+class Data_snapshot {
+  /* A Data_snapshot is a frozen copy of the library and the catalog, holding exactly
+   what sA would save at the moment it is made. The library's data comes from a copy
+   of its Record_columns, which shares the columns with the live ones, so it takes
+   constant time however many Records there are; a column is only copied when the
+   live data first changes it. The collections are kept as their names and the IDs
+   of their members, which are shared with the Collections in the same way, so the
+   whole snapshot takes time in the number of collections only. A snapshot refers
+   to no Record, so it can be saved on another thread while the live data is
+   changed, or even cleared.
+   */
+public:
+  Data_snapshot(const Record_columns& columns_, const std::vector<Collection>& catalog);
+
+  // Write the library and the catalog to the stream in save format, exactly as sA
+  // would have written them when the snapshot was made, without flushing the stream.
+  void save(std::ostream& os) const;
+
+private:
+  struct Collection_image {
+    std::string name;
+    // in title order, as they are in the Collection
+    std::shared_ptr<const std::vector<int>> member_IDs;
+  };
+  Record_columns columns;
+  std::vector<Collection_image> collections;
+};
+
+#endif
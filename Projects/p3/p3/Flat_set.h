@@ -0,0 +1,148 @@
+//
+//  Flat_set.h
+//  Project3
+//
+
+#ifndef FLAT_SET_H
+#define FLAT_SET_H
+#include <algorithm>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/* A Flat_set is a set of distinct items kept in order in a vector, with the parts
+ of the std::set interface that Collection uses. Compared to the tree in a std::set,
+ it takes only the space of the items themselves, it is traversed by going along
+ contiguous memory, and two sets are combined in one linear merge. Inserting or
+ erasing an item moves the items after it, so it is meant for sets that are read
+ and combined much more often than they are changed one item at a time, like the
+ members of a Collection.
+ The items are only ever copied between vectors, and copying them must not throw,
+ which holds for the pointers that Collection keeps.
+ */
+template<typename T, typename C>
+class Flat_set {
+  static_assert(std::is_nothrow_copy_constructible<T>::value,
+                "merging relies on copying items without exceptions");
+public:
+  // the items can't be changed in place, since that could upset the order
+  typedef typename std::vector<T>::const_iterator iterator;
+  typedef iterator const_iterator;
+
+  Flat_set() = default;
+
+  // Construct the union of two sets, allocating exactly the space it needs.
+  Flat_set(const Flat_set& lhs, const Flat_set& rhs);
+
+  iterator begin() const
+		{return items.begin();}
+  iterator end() const
+		{return items.end();}
+  std::size_t size() const
+		{return items.size();}
+  bool empty() const
+		{return items.empty();}
+  void clear()
+		{items.clear();}
+
+  // Return an iterator to the item equivalent to the supplied one, or end() if none.
+  iterator find(const T& item) const;
+  // Insert the item unless an equivalent one is present. Return an iterator to the
+  // item in the set, and whether it was inserted.
+  std::pair<iterator, bool> insert(const T& item);
+  // Remove the item that the iterator points to.
+  void erase(iterator it)
+		{items.erase(it);}
+
+  // Add the items of other that are not already present, in one linear merge into
+  // new storage of exactly the size needed, and call the function with each one
+  // that was added. If the storage can't be allocated, nothing changes.
+  template<typename F>
+  void merge(const Flat_set& other, F added);
+
+private:
+  std::vector<T> items;
+  C comp;
+
+  // the number of distinct items in the union of two sets
+  static std::size_t union_size(const Flat_set& lhs, const Flat_set& rhs);
+};
+
+template<typename T, typename C>
+Flat_set<T, C>::Flat_set(const Flat_set& lhs, const Flat_set& rhs) {
+  items.reserve(union_size(lhs, rhs));
+  std::set_union(lhs.items.begin(), lhs.items.end(), rhs.items.begin(), rhs.items.end(),
+                 std::back_inserter(items), comp);
+}
+
+template<typename T, typename C>
+typename Flat_set<T, C>::iterator Flat_set<T, C>::find(const T& item) const {
+  auto it = std::lower_bound(items.begin(), items.end(), item, comp);
+  if (it == items.end() || comp(item, *it)) {
+    return items.end();
+  }
+  return it;
+}
+
+template<typename T, typename C>
+std::pair<typename Flat_set<T, C>::iterator, bool> Flat_set<T, C>::insert(const T& item) {
+  auto it = std::lower_bound(items.cbegin(), items.cend(), item, comp);
+  if (it != items.end() && !comp(item, *it)) {
+    return std::make_pair(it, false);
+  }
+  return std::make_pair(iterator(items.insert(it, item)), true);
+}
+
+template<typename T, typename C>
+template<typename F>
+void Flat_set<T, C>::merge(const Flat_set& other, F added) {
+  std::vector<T> merged;
+  // the only step that can throw
+  merged.reserve(union_size(*this, other));
+  auto this_it = items.begin();
+  auto other_it = other.items.begin();
+  while (this_it != items.end() && other_it != other.items.end()) {
+    if (comp(*this_it, *other_it)) {
+      merged.push_back(*this_it++);
+    }
+    else if (comp(*other_it, *this_it)) {
+      added(*other_it);
+      merged.push_back(*other_it++);
+    }
+    else {
+      merged.push_back(*this_it++);
+      ++other_it;
+    }
+  }
+  merged.insert(merged.end(), this_it, items.end());
+  for (; other_it != other.items.end(); ++other_it) {
+    added(*other_it);
+    merged.push_back(*other_it);
+  }
+  items.swap(merged);
+}
+
+template<typename T, typename C>
+std::size_t Flat_set<T, C>::union_size(const Flat_set& lhs, const Flat_set& rhs) {
+  std::size_t size = lhs.items.size() + rhs.items.size();
+  // each item in both is counted twice above
+  auto lhs_it = lhs.items.begin();
+  auto rhs_it = rhs.items.begin();
+  while (lhs_it != lhs.items.end() && rhs_it != rhs.items.end()) {
+    if (lhs.comp(*lhs_it, *rhs_it)) {
+      ++lhs_it;
+    }
+    else if (lhs.comp(*rhs_it, *lhs_it)) {
+      ++rhs_it;
+    }
+    else {
+      --size;
+      ++lhs_it;
+      ++rhs_it;
+    }
+  }
+  return size;
+}
+
+#endif
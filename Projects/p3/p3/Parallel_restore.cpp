@@ -0,0 +1,212 @@
+//
+//  Parallel_restore.cpp
+//  Project3
+//
+
+#include "Parallel_restore.h"
+#include "Record.h"
+#include "Utility.h"
+#include <algorithm>
+#include <climits>
+#include <cstring>
+#include <functional>
+#include <future>
+#include <string>
+#include <thread>
+using namespace std;
+
+// how parsing a part of the record lines turned out
+enum Parse_result_e {PARSED, INVALID_DATA, IRREGULAR};
+
+struct Part_result {
+  Parse_result_e result;
+  int max_ID;
+};
+
+// the characters that stream input skips as whitespace
+static bool is_space(char c) {
+  return c == ' ' || c == '\t' || c == '\n' || c == '\v' || c == '\f' || c == '\r';
+}
+
+// the whitespace that may separate the fields of a record line
+static bool is_blank(char c) {
+  return c == ' ' || c == '\t';
+}
+
+static void skip_blanks(const char*& p, const char* line_end) {
+  while (p != line_end && is_blank(*p)) {
+    ++p;
+  }
+}
+
+// Parse an int as stream input would, returning false if there isn't one or it
+// doesn't fit in an int.
+static bool parse_int(const char*& p, const char* line_end, int& value) {
+  bool negative = false;
+  if (p != line_end && (*p == '+' || *p == '-')) {
+    negative = *p == '-';
+    ++p;
+  }
+  const char* digits = p;
+  long long magnitude = 0;
+  while (p != line_end && *p >= '0' && *p <= '9') {
+    magnitude = magnitude * 10 + (*p++ - '0');
+    if (magnitude > -(long long)INT_MIN) {
+      return false;
+    }
+  }
+  long long signed_value = negative ? -magnitude : magnitude;
+  if (p == digits || signed_value > INT_MAX) {
+    return false;
+  }
+  value = int(signed_value);
+  return true;
+}
+
+/* Parse one record line, without its newline, into a new Record. The fields must be
+ separated by blanks, and what Record(ifstream&) reads as the title is everything
+ after the one character following the rating. */
+static Parse_result_e parse_line(const char* p, const char* line_end, Record*& rec_ptr) {
+  int ID, rating;
+  skip_blanks(p, line_end);
+  if (!parse_int(p, line_end, ID) || p == line_end || !is_blank(*p)) {
+    return IRREGULAR;
+  }
+  skip_blanks(p, line_end);
+  const char* medium_start = p;
+  while (p != line_end && !is_space(*p)) {
+    ++p;
+  }
+  if (p == medium_start || p == line_end || !is_blank(*p)) {
+    return IRREGULAR;
+  }
+  const char* medium_end = p;
+  skip_blanks(p, line_end);
+  // Record(ifstream&) would take the newline as the separator before the title
+  if (!parse_int(p, line_end, rating) || p == line_end) {
+    return IRREGULAR;
+  }
+  try {
+    rec_ptr = new Record(ID, string(medium_start, medium_end), rating, string(p + 1, line_end));
+  }
+  catch (Error&) {
+    return INVALID_DATA;
+  }
+  return PARSED;
+}
+
+// Parse the lines from first to last, starting at p and each ending in a newline
+// before end, into records, stopping at the first one that can't be parsed.
+static Part_result parse_part(const char* p, const char* end, int first, int last,
+                              vector<Record*>& records) {
+  Part_result part_result = {PARSED, 0};
+  for (int i = first; i < last; i++) {
+    const char* line_end = static_cast<const char*>(memchr(p, '\n', size_t(end - p)));
+    part_result.result = parse_line(p, line_end, records[i]);
+    if (part_result.result != PARSED) {
+      break;
+    }
+    part_result.max_ID = max(part_result.max_ID, records[i]->get_ID());
+    p = line_end + 1;
+  }
+  return part_result;
+}
+
+// Read the Records from a file in save format, parsing them on several threads.
+bool restore_records_in_parallel(ifstream& is, int num_rec, vector<Record*>& library,
+                                 int num_threads) {
+  if (num_rec <= 0) {
+    return false;
+  }
+  if (num_threads < 1) {
+    num_threads = max(1, int(thread::hardware_concurrency()));
+  }
+  streampos records_start = is.tellg();
+  is.seekg(0, ios::end);
+  streamoff size = is.tellg() - records_start;
+  is.seekg(records_start);
+  if (records_start < 0 || size <= 0) {
+    is.clear();
+    is.seekg(records_start);
+    return false;
+  }
+  string buffer(size_t(size), '\0');
+  if (!is.read(&buffer[0], size)) {
+    is.clear();
+    is.seekg(records_start);
+    return false;
+  }
+  const char* p = buffer.data();
+  const char* end = p + buffer.size();
+  // the rest of the line with the number of records must be blank
+  skip_blanks(p, end);
+  if (p == end || *p != '\n') {
+    is.seekg(records_start);
+    return false;
+  }
+  ++p;
+  // find where each thread's part starts; every record line must end in a newline
+  int lines_per_part = (num_rec + num_threads - 1) / num_threads;
+  vector<const char*> part_starts;
+  for (int i = 0; i < num_rec; i++) {
+    if (i % lines_per_part == 0) {
+      part_starts.push_back(p);
+    }
+    p = static_cast<const char*>(memchr(p, '\n', size_t(end - p)));
+    if (!p) {
+      is.seekg(records_start);
+      return false;
+    }
+    ++p;
+  }
+  streamoff records_size = p - buffer.data();
+
+  vector<Record*> records(num_rec, nullptr);
+  vector<future<Part_result>> parts;
+  Parse_result_e result = PARSED;
+  int max_ID = 0;
+  try {
+    for (size_t part = 0; part < part_starts.size(); part++) {
+      int first = int(part) * lines_per_part;
+      parts.push_back(async(launch::async, parse_part, part_starts[part], end, first,
+                            min(num_rec, first + lines_per_part), ref(records)));
+    }
+    // a part that isn't in the usual form takes precedence over invalid data in
+    // another, since reading one record at a time might not see the invalid data
+    for (future<Part_result>& part : parts) {
+      Part_result part_result = part.get();
+      result = max(result, part_result.result);
+      max_ID = max(max_ID, part_result.max_ID);
+    }
+  }
+  catch (...) {
+    // wait for the rest of the threads before deleting what they made
+    for (future<Part_result>& part : parts) {
+      if (part.valid()) {
+        part.wait();
+      }
+    }
+    Record::delete_all(records);
+    throw;
+  }
+  if (result != PARSED) {
+    Record::delete_all(records);
+    if (result == INVALID_DATA) {
+      throw_file_exception();
+    }
+    is.seekg(records_start);
+    return false;
+  }
+  // a file saved from a library is in title order already; otherwise, Records with
+  // the same title end up in the reverse of their order in the file
+  if (adjacent_find(records.begin(), records.end(), [](const Record* lhs, const Record* rhs) {
+    return !(*lhs < *rhs);}) != records.end()) {
+    reverse(records.begin(), records.end());
+    stable_sort(records.begin(), records.end(), [](const Record* lhs, const Record* rhs) {
+      return *lhs < *rhs;});
+  }
+  Record::note_saved_ID(max_ID);
+  library.swap(records);
+  is.seekg(records_start + records_size);
+  return true;
+}
@@ -0,0 +1,34 @@
+//
+//  Parallel_restore.h
+//  Project3
+//
+
+#ifndef PARALLEL_RESTORE_H
+#define PARALLEL_RESTORE_H
+#include "Record.h"
+#include <fstream>
+#include <vector>
+
+/* Read the Records from a file in save format whose number of Records, num_rec, has
+ just been read, parsing them on up to num_threads threads at once. If num_threads
+ is less than 1, it is set to the number of hardware threads.
+
+ The rest of the file is read into memory with one read, and the record lines are
+ found by scanning for newlines and divided into a contiguous part for each thread.
+ This only handles the usual form of the file, in which the count is alone on its
+ line and each Record takes exactly one line, since that is what the lines can be
+ divided up by. For anything else - blank lines, a Record spread over several lines,
+ a number too big for an int, a missing line - false is returned and the stream is
+ left where it was, so that the Records can be read one at a time with
+ Record(ifstream&), which gives exactly the same result or error for that file as
+ it always has.
+
+ Otherwise, true is returned, library has the Records in the order inserting each
+ one at its lower bound by title would leave them, the ID counter is updated as
+ Record(ifstream&) would have updated it, and the stream is positioned after the
+ record lines. If the data in a record line is invalid, the same Error exception is
+ thrown as Record(ifstream&) throws, and nothing is changed. */
+bool restore_records_in_parallel(std::ifstream& is, int num_rec,
+                                 std::vector<Record*>& library, int num_threads = 0);
+
+#endif
@@ -0,0 +1,98 @@
+//
+//  Parallel_save.cpp
+//  Project3
+//
+
+#include "Parallel_save.h"
+#include "Record.h"
+#include "Collection.h"
+#include <algorithm>
+#include <functional>
+#include <future>
+#include <sstream>
+#include <string>
+#include <thread>
+using namespace std;
+
+// Lines of output per chunk, roughly; a chunk of Records is then about a megabyte.
+static const size_t lines_per_chunk = 16384;
+
+// the number of lines an item takes in the save file
+static size_t num_lines(const Record*) {
+  return 1;
+}
+static size_t num_lines(const Collection& col) {
+  return 1 + col.get_members().size();
+}
+
+static void save_item(ostream& os, const Record* rec_ptr) {
+  rec_ptr->save(os);
+}
+static void save_item(ostream& os, const Collection& col) {
+  col.save(os);
+}
+
+// Return the items from first up to last formatted in save format.
+template<typename T>
+static string format_chunk(const vector<T>& items, size_t first, size_t last) {
+  ostringstream chunk;
+  for (size_t i = first; i < last; i++) {
+    save_item(chunk, items[i]);
+  }
+  return chunk.str();
+}
+
+/* Divide the items into chunks of about lines_per_chunk lines each, a Collection
+ with more lines than that being a chunk by itself, and return where each chunk
+ starts, followed by the number of items. */
+template<typename T>
+static vector<size_t> get_chunk_starts(const vector<T>& items) {
+  vector<size_t> chunk_starts(1, 0);
+  size_t lines_in_chunk = 0;
+  for (size_t i = 0; i < items.size(); i++) {
+    lines_in_chunk += num_lines(items[i]);
+    if (lines_in_chunk >= lines_per_chunk) {
+      chunk_starts.push_back(i + 1);
+      lines_in_chunk = 0;
+    }
+  }
+  if (chunk_starts.back() != items.size()) {
+    chunk_starts.push_back(items.size());
+  }
+  return chunk_starts;
+}
+
+// Format the chunks of items num_threads at a time, and write each round of them
+// in order before starting the next, so only num_threads chunks are held at once.
+template<typename T>
+static void save_chunks(ostream& os, const vector<T>& items, int num_threads) {
+  vector<size_t> chunk_starts = get_chunk_starts(items);
+  size_t num_chunks = chunk_starts.size() - 1;
+  for (size_t first = 0; first < num_chunks; first += num_threads) {
+    size_t last = min(num_chunks, first + num_threads);
+    vector<future<string>> chunks;
+    for (size_t c = first; c < last; c++) {
+      chunks.push_back(async(launch::async, format_chunk<T>, cref(items),
+                             chunk_starts[c], chunk_starts[c + 1]));
+    }
+    // get rethrows anything thrown by the formatting
+    for (future<string>& chunk : chunks) {
+      string text = chunk.get();
+      os.write(text.data(), text.size());
+    }
+  }
+}
+
+// Write the library and the catalog to the stream in save format, formatting them
+// in parallel.
+void save_in_parallel(ostream& os, const vector<Record*>& library,
+                      const vector<Collection>& catalog, int num_threads) {
+  if (num_threads < 1) {
+    num_threads = max(1, int(thread::hardware_concurrency()));
+  }
+  os << library.size() << '\n';
+  save_chunks(os, library, num_threads);
+  os << catalog.size() << '\n';
+  save_chunks(os, catalog, num_threads);
+  os.flush();
+}
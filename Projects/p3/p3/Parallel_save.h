@@ -0,0 +1,24 @@
+//
+//  Parallel_save.h
+//  Project3
+//
+
+#ifndef PARALLEL_SAVE_H
+#define PARALLEL_SAVE_H
+#include "Record.h"
+#include "Collection.h"
+#include <ostream>
+#include <vector>
+
+/* Write the library and the catalog to the stream in save format, exactly as
+ writing the number of Records, each Record with Record::save, the number of
+ Collections, and each Collection with Collection::save would. The Records and
+ Collections are formatted into large in-memory chunks by up to num_threads threads
+ at once, each taking a contiguous slice, and the chunks are written in order with
+ one write each; the stream is flushed once at the end. Only a few chunks per thread
+ are held in memory at a time. If num_threads is less than 1, it is set to the
+ number of hardware threads. An exception thrown while formatting is rethrown here. */
+void save_in_parallel(std::ostream& os, const std::vector<Record*>& library,
+                      const std::vector<Collection>& catalog, int num_threads = 0);
+
+#endif
@@ -0,0 +1,62 @@
+//
+//  Rating_index.cpp
+//  Project3
+//
+
+#include "Rating_index.h"
+#include "Record.h"
+#include <algorithm>
+using namespace std;
+
+// order of the Records within a rating
+static bool title_less(const Record* lhs, const Record* rhs) {
+  return *lhs < *rhs;
+}
+
+// Add the Record under its current rating.
+void Rating_index::insert(const Record* rec_ptr) {
+  vector<const Record*>& records = by_rating[rec_ptr->get_rating()];
+  records.insert(lower_bound(records.begin(), records.end(), rec_ptr, title_less),
+                 rec_ptr);
+  ++num_records;
+}
+
+// Remove the Record from under its current rating; nothing happens if it isn't there.
+void Rating_index::remove(const Record* rec_ptr) {
+  vector<const Record*>& records = by_rating[rec_ptr->get_rating()];
+  auto it = lower_bound(records.begin(), records.end(), rec_ptr, title_less);
+  if (it != records.end() && *it == rec_ptr) {
+    records.erase(it);
+    --num_records;
+  }
+}
+
+// Replace the contents with the supplied Records, which must be in title order.
+void Rating_index::rebuild(const vector<Record*>& library_title) {
+  vector<const Record*> new_by_rating[num_ratings];
+  // appending in title order leaves each rating in title order
+  for (Record* rec_ptr : library_title) {
+    new_by_rating[rec_ptr->get_rating()].push_back(rec_ptr);
+  }
+  // nothing changes unless all of the vectors could be built
+  for (int rating = 0; rating < num_ratings; rating++) {
+    by_rating[rating].swap(new_by_rating[rating]);
+  }
+  num_records = int(library_title.size());
+}
+
+// exchange the contents with another index, without copying them
+void Rating_index::swap(Rating_index& other) noexcept {
+  for (int rating = 0; rating < num_ratings; rating++) {
+    by_rating[rating].swap(other.by_rating[rating]);
+  }
+  std::swap(num_records, other.num_records);
+}
+
+// discard all Records
+void Rating_index::clear() {
+  for (vector<const Record*>& records : by_rating) {
+    records.clear();
+  }
+  num_records = 0;
+}
@@ -0,0 +1,67 @@
+//
+//  Rating_index.h
+//  Project3
+//
+
+#ifndef RATING_INDEX_H
+#define RATING_INDEX_H
+#include "Record.h"
+#include <vector>
+
+class Rating_index {
+  /* A Rating_index keeps Records in the order lr lists them: from the highest rating
+   down, with the unrated Records last, and in title order within each rating. Since
+   a rating is one of only a few values, the Records with each rating are kept in
+   their own vector in title order, and the position of a Record in the whole order
+   is its position in its vector plus the sizes of the vectors before it. The index
+   does not own the Records; the library it is kept for must add and remove each
+   Record here whenever it adds or removes one, or changes its title or rating.
+   */
+public:
+  // Add the Record under its current rating.
+  void insert(const Record* rec_ptr);
+  // Remove the Record from under its current rating; nothing happens if it isn't there.
+  // The title and rating must be the same as when the Record was inserted.
+  void remove(const Record* rec_ptr);
+  // Replace the contents with the supplied Records, which must be in title order.
+  void rebuild(const std::vector<Record*>& library_title);
+  // discard all Records
+  void clear();
+  // exchange the contents with another index, without copying them
+  void swap(Rating_index& other) noexcept;
+  // the number of Records in the index
+  int size() const
+		{return num_records;}
+
+  // Call the function with each of up to count Records in rating order, starting at
+  // position offset; there may be fewer than count Records from there to the end.
+  // No Records are copied, and the starting Record is found in constant time.
+  template<typename F>
+  void apply(int offset, int count, F function) const;
+
+private:
+  static const int num_ratings = 6;
+  // the Records with each rating, in title order, indexed by rating; 0 is unrated
+  std::vector<const Record*> by_rating[num_ratings];
+  int num_records = 0;
+};
+
+template<typename F>
+void Rating_index::apply(int offset, int count, F function) const {
+  // the highest rating comes first, so unrated Records (rating 0) come last
+  for (int rating = num_ratings - 1; count > 0 && rating >= 0; rating--) {
+    const std::vector<const Record*>& records = by_rating[rating];
+    int num_in_rating = int(records.size());
+    // skip the whole rating if the starting position is beyond it
+    if (offset >= num_in_rating) {
+      offset -= num_in_rating;
+      continue;
+    }
+    for (int i = offset; count > 0 && i < num_in_rating; i++, count--) {
+      function(records[i]);
+    }
+    offset = 0;
+  }
+}
+
+#endif
@@ -18,6 +18,45 @@ int Record::ID_back_up = 0;
 const int Record::min_rating = 1;
 const int Record::max_rating = 5;
 
+// Records are allocated a slab of this many at a time
+static const int records_per_slab = 512;
+
+// The pool is made on first use, so that it exists before any Record is created.
+Slab_pool& Record::pool() {
+  static Slab_pool record_pool(sizeof(Record), alignof(Record), records_per_slab);
+  return record_pool;
+}
+
+const Slab_pool& Record::get_pool() {
+  return pool();
+}
+
+// a Record of a class derived from Record is a different size, and is allocated
+// as usual
+void* Record::operator new(size_t size) {
+  if (size != sizeof(Record)) {
+    return ::operator new(size);
+  }
+  return pool().allocate();
+}
+
+void Record::operator delete(void* ptr, size_t size) noexcept {
+  if (size != sizeof(Record)) {
+    ::operator delete(ptr);
+    return;
+  }
+  pool().deallocate(ptr);
+}
+
+void Record::delete_all(const vector<Record*>& rec_ptrs) noexcept {
+  for (Record* rec_ptr : rec_ptrs) {
+    if (rec_ptr) {
+      rec_ptr->~Record();
+    }
+  }
+  pool().deallocate_all(rec_ptrs.begin(), rec_ptrs.end());
+}
+
 // Create a Record object initialized with the supplied values. Rating is set to 0.
 Record::Record(const string& medium_, const string& title_) :
 medium(medium_), title(title_), rating(0) {
@@ -32,12 +71,11 @@ Record::Record(ifstream& is) {
   if (!(is >> ID >> medium >> rating)) {
     throw_file_exception();
   }
-  if (ID < 0 || rating < 0) {
+  // a rating outside the range set_rating allows is invalid data
+  if (ID < 0 || rating < 0 || rating > max_rating) {
     throw_file_exception();
   }
-  if (ID > ID_counter) {
-    ID_counter = ID;
-  }
+  note_saved_ID(ID);
   // now care about 1 leading whitespace
   if (!(is.get())) {
     throw_file_exception();
@@ -45,6 +83,15 @@ Record::Record(ifstream& is) {
   getline(is, title);
 }
 
+// Create a Record object with the supplied data, as read from a file in save format.
+// The data is checked as Record(ifstream&) checks it; the ID counter is left alone.
+Record::Record(int ID_, const string& medium_, int rating_, const string& title_) :
+medium(medium_), title(title_), ID(ID_), rating(rating_) {
+  if (ID < 0 || rating < 0 || rating > max_rating) {
+    throw_file_exception();
+  }
+}
+
 // if the rating is not between 1 and 5 inclusive, an exception is thrown
 void Record::set_rating(int rating_) {
   if (rating_ < min_rating || rating_ > max_rating) {
@@ -58,10 +105,11 @@ void Record::set_title(const string& title_) {
   title = title_;
 }
 
-// Write a Record's data to a stream in save format with final endl.
-// The record ID number is saved.
+// Write a Record's data to a stream in save format with final newline.
+// The record ID number is saved. The stream is not flushed, so that saving many
+// Records doesn't flush after each one.
 void Record::save(ostream& os) const {
-  os << ID << " " << medium << " " << rating << " " << title << endl;
+  os << ID << " " << medium << " " << rating << " " << title << '\n';
 }
 
 // Print a Record's data to the stream without a final endl.
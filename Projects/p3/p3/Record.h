@@ -8,9 +8,12 @@
 
 #ifndef RECORD_H
 #define RECORD_H
+#include "Slab_pool.h"
+#include <cstddef>
 #include <fstream>
 #include <ostream>
 #include <string>
+#include <vector>
 class Record {
   /*
    A Record ontains a unique ID number, a rating, and a title and medium name as 
@@ -33,6 +36,13 @@ public:
   // Input string data is read directly into the member variables.
   // The record number will be set from the saved data.
   Record(std::ifstream& is);
+
+  // Create a Record object with the supplied data, as read from a file in save format
+  // by a restore that does its own parsing. The data is checked as Record(ifstream&)
+  // checks it, throwing the same Error exception. Unlike that constructor, this one
+  // leaves the ID counter alone, so that Records can be created on several threads
+  // at once; note_saved_ID must be called with the highest ID afterwards.
+  Record(int ID_, const std::string& medium_, int rating_, const std::string& title_);
   
   // These declarations help ensure that Record objects are unique
   Record(const Record&) = delete;	// disallow copy construction
@@ -45,9 +55,15 @@ public:
 		{return ID;}
   const std::string& get_title() const
 		{return title;}
+  const std::string& get_medium() const
+		{return medium;}
   int get_rating() const {
     return rating;
   }
+  // the number of Collections the Record is a member of, kept by Collection
+  int get_num_collections() const {
+    return num_collections;
+  }
   // if the rating is not between 1 and 5 inclusive, an exception is thrown
   void set_rating(int rating_);
   // modifies title of a record
@@ -72,9 +88,27 @@ public:
   static void restore_ID_counter() {
     ID_counter = ID_back_up;
   }
+  // make sure new IDs are above a saved ID, as Record(ifstream&) does for its own
+  static void note_saved_ID(int ID_) {
+    if (ID_ > ID_counter) {
+      ID_counter = ID_;
+    }
+  }
+
+  // Records created with new are allocated from slabs of many Records at a time, so
+  // that their addresses stay the same while a freed slot is reused by the next
+  // Record, and a slab is released as a whole once all its Records are deleted,
+  // apart from one empty slab that is kept for the next Records.
+  static void* operator new(std::size_t size);
+  static void operator delete(void* ptr, std::size_t size) noexcept;
+  // Delete all of the Records, skipping null pointers, and hand their memory back
+  // to the slabs all at once rather than one Record at a time.
+  static void delete_all(const std::vector<Record*>& rec_ptrs) noexcept;
+  // the pool of slabs, for reporting how full they are
+  static const Slab_pool& get_pool();
 
-  // Write a Record's data to a stream in save format with final endl.
-  // The record ID number is saved.
+  // Write a Record's data to a stream in save format with final newline, without
+  // flushing the stream. The record ID number is saved.
   void save(std::ostream& os) const;
   
   // This operator defines the order relation between Records, based just on the title.
@@ -91,13 +125,17 @@ public:
   }
   /* *** fill in a friend declaration for the output operator */
   friend std::ostream& operator<< (std::ostream& os, const Record& record);
+  // Collection keeps num_collections up to date as members are added and removed
+  friend class Collection;
 private:
   std::string medium;
   std::string title;
   int ID;
   int rating;
+  int num_collections = 0;
   static int ID_counter;
   static int ID_back_up;
+  static Slab_pool& pool();
   static const int min_rating;
   static const int max_rating;
 };
@@ -0,0 +1,317 @@
+//
+//  Record_columns.cpp
+//  Project3
+//
+
+#include "Record_columns.h"
+#include "Record.h"
+#include <algorithm>
+#include <cstring>
+#include <utility>
+using namespace std;
+
+// ratings go from 0, for unrated, to 5
+static const int num_ratings = 6;
+
+// Make sure there is room for one more element, growing the capacity geometrically
+// as push_back would, so that inserting it afterwards can't fail.
+template<typename T>
+static void make_room(vector<T>& column) {
+  if (column.size() == column.capacity()) {
+    column.reserve(2 * column.size() + 1);
+  }
+}
+
+// Return the column for changing, giving this Record_columns a copy of its own
+// first if the column is shared with another.
+template<typename T>
+static T& writable(shared_ptr<T>& column) {
+  if (column.use_count() > 1) {
+    column = make_shared<T>(*column);
+  }
+  return *column;
+}
+
+// Empty the column, releasing its memory, or stop sharing it with another.
+template<typename T>
+static void clear_column(shared_ptr<T>& column) {
+  if (column.use_count() > 1) {
+    column = make_shared<T>();
+  }
+  else {
+    T().swap(*column);
+  }
+}
+
+// Deselect the rows whose value in the column doesn't satisfy the predicate. The
+// loop has no branches, so the compiler can vectorize it.
+template<typename T, typename P>
+static void restrict_if(Record_columns::Selection_t& selection, const vector<T>& column,
+                        P predicate) {
+  unsigned char* selected = selection.data();
+  const T* values = column.data();
+  size_t num_rows = column.size();
+  for (size_t row = 0; row < num_rows; row++) {
+    selected[row] &= static_cast<unsigned char>(predicate(int(values[row])));
+  }
+}
+
+template<typename T>
+static void restrict_column(Record_columns::Selection_t& selection, const vector<T>& column,
+                            Record_columns::Comparison_e comparison, int value) {
+  switch (comparison) {
+    case Record_columns::EQUAL:
+      restrict_if(selection, column, [value](int x) {return x == value;});
+      break;
+    case Record_columns::NOT_EQUAL:
+      restrict_if(selection, column, [value](int x) {return x != value;});
+      break;
+    case Record_columns::LESS:
+      restrict_if(selection, column, [value](int x) {return x < value;});
+      break;
+    case Record_columns::LESS_EQUAL:
+      restrict_if(selection, column, [value](int x) {return x <= value;});
+      break;
+    case Record_columns::GREATER:
+      restrict_if(selection, column, [value](int x) {return x > value;});
+      break;
+    case Record_columns::GREATER_EQUAL:
+      restrict_if(selection, column, [value](int x) {return x >= value;});
+      break;
+  }
+}
+
+Record_columns::Record_columns() :
+ids(make_shared<vector<int>>()), ratings(make_shared<vector<signed char>>()),
+medium_codes(make_shared<vector<int>>()), title_offsets(make_shared<vector<size_t>>()),
+title_lengths(make_shared<vector<int>>()), titles(make_shared<string>()),
+media(make_shared<vector<string>>()),
+codes_by_medium(make_shared<unordered_map<string, int>>()) {}
+
+// Add a row for the Record at its place in ID order.
+void Record_columns::insert(const Record* rec_ptr) {
+  // the titles of removed Records are dropped once they are most of the string
+  if (num_unused_title_chars > titles->size() / 2) {
+    compact_titles();
+  }
+  int medium_code = get_medium_code(rec_ptr->get_medium());
+  if (medium_code < 0) {
+    vector<string>& media_by_code = writable(media);
+    unordered_map<string, int>& codes = writable(codes_by_medium);
+    medium_code = int(media_by_code.size());
+    media_by_code.push_back(rec_ptr->get_medium());
+    try {
+      codes[rec_ptr->get_medium()] = medium_code;
+    } catch (...) {
+      media_by_code.pop_back();
+      throw;
+    }
+  }
+  // anything that fails after the title is added leaves it unused
+  string& title_chars = writable(titles);
+  size_t title_offset = title_chars.size();
+  title_chars += rec_ptr->get_title();
+  try {
+    make_room(writable(ids));
+    make_room(writable(ratings));
+    make_room(writable(medium_codes));
+    make_room(writable(title_offsets));
+    make_room(writable(title_lengths));
+  } catch (...) {
+    num_unused_title_chars += rec_ptr->get_title().size();
+    throw;
+  }
+  // nothing below can fail
+  size_t row = lower_bound_row(rec_ptr->get_ID());
+  ids->insert(ids->begin() + row, rec_ptr->get_ID());
+  ratings->insert(ratings->begin() + row, static_cast<signed char>(rec_ptr->get_rating()));
+  medium_codes->insert(medium_codes->begin() + row, medium_code);
+  title_offsets->insert(title_offsets->begin() + row, title_offset);
+  title_lengths->insert(title_lengths->begin() + row, int(rec_ptr->get_title().size()));
+}
+
+// Remove the row for the Record; nothing happens if it isn't there.
+void Record_columns::remove(const Record* rec_ptr) {
+  size_t row = lower_bound_row(rec_ptr->get_ID());
+  if (row == ids->size() || (*ids)[row] != rec_ptr->get_ID()) {
+    return;
+  }
+  // make every column writable before changing any, so that none change if a copy fails
+  vector<int>& id_column = writable(ids);
+  vector<signed char>& rating_column = writable(ratings);
+  vector<int>& medium_column = writable(medium_codes);
+  vector<size_t>& offset_column = writable(title_offsets);
+  vector<int>& length_column = writable(title_lengths);
+  num_unused_title_chars += length_column[row];
+  id_column.erase(id_column.begin() + row);
+  rating_column.erase(rating_column.begin() + row);
+  medium_column.erase(medium_column.begin() + row);
+  offset_column.erase(offset_column.begin() + row);
+  length_column.erase(length_column.begin() + row);
+}
+
+// Copy the Record's current rating into its row.
+void Record_columns::update_rating(const Record* rec_ptr) {
+  size_t row = lower_bound_row(rec_ptr->get_ID());
+  if (row != ids->size() && (*ids)[row] == rec_ptr->get_ID()) {
+    writable(ratings)[row] = static_cast<signed char>(rec_ptr->get_rating());
+  }
+}
+
+// Replace the rows with ones for the supplied Records, which must be in ID order.
+void Record_columns::rebuild(const vector<Record*>& library_id) {
+  Record_columns new_columns;
+  size_t num_records = library_id.size();
+  new_columns.ids->reserve(num_records);
+  new_columns.ratings->reserve(num_records);
+  new_columns.medium_codes->reserve(num_records);
+  new_columns.title_offsets->reserve(num_records);
+  new_columns.title_lengths->reserve(num_records);
+  size_t titles_size = 0;
+  for (const Record* rec_ptr : library_id) {
+    titles_size += rec_ptr->get_title().size();
+  }
+  new_columns.titles->reserve(titles_size);
+  // appending in ID order leaves the rows in ID order
+  for (const Record* rec_ptr : library_id) {
+    new_columns.insert(rec_ptr);
+  }
+  // nothing changes unless all of the columns could be built
+  swap(new_columns);
+}
+
+// discard all rows
+void Record_columns::clear() {
+  clear_column(ids);
+  clear_column(ratings);
+  clear_column(medium_codes);
+  clear_column(title_offsets);
+  clear_column(title_lengths);
+  clear_column(titles);
+  num_unused_title_chars = 0;
+  clear_column(media);
+  clear_column(codes_by_medium);
+}
+
+// exchange the contents with another set of columns, without copying them
+void Record_columns::swap(Record_columns& other) noexcept {
+  ids.swap(other.ids);
+  ratings.swap(other.ratings);
+  medium_codes.swap(other.medium_codes);
+  title_offsets.swap(other.title_offsets);
+  title_lengths.swap(other.title_lengths);
+  titles.swap(other.titles);
+  std::swap(num_unused_title_chars, other.num_unused_title_chars);
+  media.swap(other.media);
+  codes_by_medium.swap(other.codes_by_medium);
+}
+
+// the code a medium is kept as, or -1 if no Record with that medium was added
+int Record_columns::get_medium_code(const string& medium) const {
+  auto it = codes_by_medium->find(medium);
+  return it == codes_by_medium->end() ? -1 : it->second;
+}
+
+// Deselect the rows whose field doesn't compare to value as supplied.
+void Record_columns::restrict(Selection_t& selection, Field_e field, Comparison_e comparison,
+                              int value) const {
+  switch (field) {
+    case ID_FIELD:
+      restrict_column(selection, *ids, comparison, value);
+      break;
+    case RATING_FIELD:
+      restrict_column(selection, *ratings, comparison, value);
+      break;
+    case MEDIUM_FIELD:
+      restrict_column(selection, *medium_codes, comparison, value);
+      break;
+  }
+}
+
+// the number of rows selected
+int Record_columns::count(const Selection_t& selection) const {
+  int num_selected = 0;
+  for (unsigned char selected : selection) {
+    num_selected += selected;
+  }
+  return num_selected;
+}
+
+// The rows with each rating are counted in a separate pass, since a pass that
+// incremented the count for each row's rating couldn't be vectorized.
+vector<int> Record_columns::count_by_rating(const Selection_t& selection) const {
+  vector<int> counts(num_ratings, 0);
+  const vector<signed char>& rating_column = *ratings;
+  size_t num_rows = rating_column.size();
+  for (int rating = 0; rating < num_ratings; rating++) {
+    int num_selected = 0;
+    for (size_t row = 0; row < num_rows; row++) {
+      num_selected += selection[row] & (rating_column[row] == rating);
+    }
+    counts[rating] = num_selected;
+  }
+  return counts;
+}
+
+// Print each row selected as its Record prints, one to a line, in ID order.
+void Record_columns::print(ostream& os, const Selection_t& selection) const {
+  for (size_t row = 0; row < ids->size(); row++) {
+    if (!selection[row]) {
+      continue;
+    }
+    os << (*ids)[row] << ": " << (*media)[(*medium_codes)[row]] << " ";
+    if (!(*ratings)[row]) {
+      os << "u";
+    }
+    else {
+      os << int((*ratings)[row]);
+    }
+    os << " ";
+    write_title(os, row);
+    os << '\n';
+  }
+}
+
+// whether the title in one row comes before the title in the other, comparing
+// them as std::string does
+bool Record_columns::title_less(size_t lhs_row, size_t rhs_row) const {
+  const char* lhs = titles->data() + (*title_offsets)[lhs_row];
+  const char* rhs = titles->data() + (*title_offsets)[rhs_row];
+  int lhs_length = (*title_lengths)[lhs_row];
+  int rhs_length = (*title_lengths)[rhs_row];
+  int result = memcmp(lhs, rhs, size_t(min(lhs_length, rhs_length)));
+  return result < 0 || (result == 0 && lhs_length < rhs_length);
+}
+
+// Write the row in save format, as Record::save writes its Record.
+void Record_columns::save_row(ostream& os, size_t row) const {
+  os << (*ids)[row] << " " << (*media)[(*medium_codes)[row]] << " " << int((*ratings)[row])
+  << " ";
+  write_title(os, row);
+  os << '\n';
+}
+
+// write the title in the row, without a newline
+void Record_columns::write_title(ostream& os, size_t row) const {
+  os.write(titles->data() + (*title_offsets)[row], (*title_lengths)[row]);
+}
+
+// the row for the ID if there is one, or where it would go if not
+size_t Record_columns::lower_bound_row(int ID) const {
+  return size_t(std::lower_bound(ids->begin(), ids->end(), ID) - ids->begin());
+}
+
+// copy the titles still in use to a new string, in row order
+void Record_columns::compact_titles() {
+  auto new_titles = make_shared<string>();
+  new_titles->reserve(titles->size() - num_unused_title_chars);
+  auto new_offsets = make_shared<vector<size_t>>(title_offsets->size());
+  for (size_t row = 0; row < title_offsets->size(); row++) {
+    (*new_offsets)[row] = new_titles->size();
+    new_titles->append(*titles, (*title_offsets)[row], (*title_lengths)[row]);
+  }
+  // a copy sharing the old ones keeps them
+  titles.swap(new_titles);
+  title_offsets.swap(new_offsets);
+  num_unused_title_chars = 0;
+}
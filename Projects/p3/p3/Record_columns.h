@@ -0,0 +1,106 @@
+//
+//  Record_columns.h
+//  Project3
+//
+
+#ifndef RECORD_COLUMNS_H
+#define RECORD_COLUMNS_H
+#include "Record.h"
+#include <cstddef>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+class Record_columns {
+  /* A Record_columns keeps a copy of the data of the Records in a library a column
+   at a time: an array of the IDs, one of the ratings, one of the media as small
+   integer codes, and one of where each title is in a single string holding all of
+   them, with a row in each array for each Record, in ID order. A query that only
+   looks at a field or two scans just those arrays from start to end, in loops the
+   compiler can vectorize, instead of following a pointer to every Record. Like the
+   indexes, the columns do not own the Records; the library they are kept for must
+   add and remove each Record here whenever it adds or removes one, or changes its
+   title, and must update the rating whenever one changes.
+
+   Each column is shared by the copies of a Record_columns until one of them changes
+   it, and then that one gets a column of its own first. So a copy takes constant
+   time and is a snapshot of the library's data at that moment, which stays the same
+   however the library changes afterwards; the first change to a column after a
+   copy is made costs a copy of that column alone. Since a column is only ever
+   changed by the one Record_columns that has it to itself, a copy can be read on
+   another thread while the original is changed, as long as both are created and
+   destroyed on the same thread.
+   */
+public:
+  enum Field_e {ID_FIELD, RATING_FIELD, MEDIUM_FIELD};
+  enum Comparison_e {EQUAL, NOT_EQUAL, LESS, LESS_EQUAL, GREATER, GREATER_EQUAL};
+  // the rows a query selects, with 1 for each row selected and 0 for the rest
+  typedef std::vector<unsigned char> Selection_t;
+
+  Record_columns();
+
+  // Add a row for the Record at its place in ID order.
+  void insert(const Record* rec_ptr);
+  // Remove the row for the Record; nothing happens if it isn't there.
+  void remove(const Record* rec_ptr);
+  // Copy the Record's current rating into its row.
+  void update_rating(const Record* rec_ptr);
+  // Replace the rows with ones for the supplied Records, which must be in ID order.
+  void rebuild(const std::vector<Record*>& library_id);
+  // discard all rows
+  void clear();
+  // exchange the contents with another set of columns, without copying them
+  void swap(Record_columns& other) noexcept;
+  // the number of rows
+  int size() const
+		{return int(ids->size());}
+
+  // the code a medium is kept as, or -1 if no Record with that medium was added
+  int get_medium_code(const std::string& medium) const;
+  // a Selection_t with every row selected
+  Selection_t select_all() const
+		{return Selection_t(ids->size(), 1);}
+  // Deselect the rows whose field doesn't compare to value as supplied. A medium is
+  // compared by its code, so only EQUAL and NOT_EQUAL make sense for it.
+  void restrict(Selection_t& selection, Field_e field, Comparison_e comparison,
+                int value) const;
+  // the number of rows selected
+  int count(const Selection_t& selection) const;
+  // the number of rows selected with each rating, indexed by rating; 0 is unrated
+  std::vector<int> count_by_rating(const Selection_t& selection) const;
+  // Print each row selected as its Record prints, one to a line, in ID order.
+  void print(std::ostream& os, const Selection_t& selection) const;
+
+  // the row for the ID, which must have one
+  std::size_t find_row(int ID) const
+		{return lower_bound_row(ID);}
+  // whether the title in one row comes before the title in the other, as Records
+  // are ordered
+  bool title_less(std::size_t lhs_row, std::size_t rhs_row) const;
+  // Write the row in save format, as Record::save writes its Record.
+  void save_row(std::ostream& os, std::size_t row) const;
+  // write the title in the row, without a newline
+  void write_title(std::ostream& os, std::size_t row) const;
+
+private:
+  // the row for the ID if there is one, or where it would go if not
+  std::size_t lower_bound_row(int ID) const;
+  // copy the titles still in use to a new string, in row order
+  void compact_titles();
+
+  std::shared_ptr<std::vector<int>> ids;
+  std::shared_ptr<std::vector<signed char>> ratings;
+  std::shared_ptr<std::vector<int>> medium_codes;
+  std::shared_ptr<std::vector<std::size_t>> title_offsets;
+  std::shared_ptr<std::vector<int>> title_lengths;
+  // the titles, including those of removed Records until they are compacted away
+  std::shared_ptr<std::string> titles;
+  std::size_t num_unused_title_chars = 0;
+  // the media by code, and the codes by medium
+  std::shared_ptr<std::vector<std::string>> media;
+  std::shared_ptr<std::unordered_map<std::string, int>> codes_by_medium;
+};
+
+#endif
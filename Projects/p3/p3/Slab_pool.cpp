@@ -0,0 +1,222 @@
+//
+//  Slab_pool.cpp
+//  Project3
+//
+
+#include "Slab_pool.h"
+#include <algorithm>
+#include <cassert>
+#include <new>
+using namespace std;
+
+// A thread's cache holds up to this many free slots; it takes or hands back half
+// of them at a time.
+static const int cache_capacity = 64;
+
+struct Slab_pool::Thread_cache {
+  Slab_pool* pool = nullptr;
+  void* slots[cache_capacity];
+  int num_slots = 0;
+  // a thread that ends hands its slots back
+  ~Thread_cache() {
+    if (pool) {
+      pool->give_back(*this, num_slots);
+    }
+  }
+};
+
+static size_t round_up(size_t size, size_t alignment) {
+  return (size + alignment - 1) / alignment * alignment;
+}
+
+// The slots follow the Slab at the start of its memory, and the slabs are aligned
+// as strictly as anything could need.
+size_t Slab_pool::slab_header_size() {
+  return round_up(sizeof(Slab_pool::Slab), alignof(max_align_t));
+}
+
+// Each slot is a pointer to its slab followed by the object, which must be able to
+// hold a free list link; both are aligned for the object and for the pointer.
+Slab_pool::Slab_pool(size_t object_size_, size_t object_alignment, int slab_capacity_) :
+slot_header_size(round_up(sizeof(Slab*), max(object_alignment, alignof(Slab*)))),
+slot_size(slot_header_size + round_up(max(object_size_, sizeof(void*)),
+                                      max(object_alignment, alignof(Slab*)))),
+slab_capacity(slab_capacity_) {
+  assert(object_alignment <= alignof(max_align_t));
+}
+
+Slab_pool::~Slab_pool() {
+  while (first_slab) {
+    Slab* next = first_slab->next;
+    ::operator delete(first_slab);
+    first_slab = next;
+  }
+}
+
+// Return memory for one object, making a new slab if none has room.
+void* Slab_pool::allocate() {
+  Thread_cache& cache = get_thread_cache();
+  if (!cache.num_slots) {
+    lock_guard<mutex> lock(pool_mutex);
+    // only half a cache's worth, so that the next few deallocations fit as well
+    try {
+      while (cache.num_slots < cache_capacity / 2) {
+        cache.slots[cache.num_slots++] = take_slot();
+      }
+    }
+    catch (...) {
+      if (!cache.num_slots) {
+        throw;
+      }
+    }
+  }
+  return cache.slots[--cache.num_slots];
+}
+
+// Return the memory of an object to the pool.
+void Slab_pool::deallocate(void* ptr) noexcept {
+  if (!ptr) {
+    return;
+  }
+  Thread_cache& cache = get_thread_cache();
+  if (cache.num_slots == cache_capacity) {
+    give_back(cache, cache_capacity / 2);
+  }
+  cache.slots[cache.num_slots++] = ptr;
+}
+
+int Slab_pool::get_num_slabs() const {
+  lock_guard<mutex> lock(pool_mutex);
+  return num_slabs;
+}
+
+// The free slots in the calling thread's cache aren't counted.
+int Slab_pool::get_num_allocated() const {
+  lock_guard<mutex> lock(pool_mutex);
+  const Thread_cache& cache = this_thread_cache();
+  return num_allocated - (cache.pool == this ? cache.num_slots : 0);
+}
+
+Slab_pool::Thread_cache& Slab_pool::this_thread_cache() {
+  static thread_local Thread_cache cache;
+  return cache;
+}
+
+Slab_pool::Thread_cache& Slab_pool::get_thread_cache() {
+  Thread_cache& cache = this_thread_cache();
+  if (cache.pool != this) {
+    if (cache.pool) {
+      cache.pool->give_back(cache, cache.num_slots);
+    }
+    cache.pool = this;
+  }
+  return cache;
+}
+
+// New objects go into the slab that most recently got room, which is usually the
+// one they were freed from, and into the kept empty slab only when no other has room.
+void* Slab_pool::take_slot() {
+  if (!first_with_room) {
+    Slab* slab = spare_slab ? spare_slab : make_slab();
+    spare_slab = nullptr;
+    link_with_room(slab);
+  }
+  Slab* slab = first_with_room;
+  void* ptr;
+  if (slab->free_list) {
+    ptr = slab->free_list;
+    slab->free_list = *static_cast<void**>(ptr);
+  }
+  else {
+    char* slot = reinterpret_cast<char*>(slab) + slab_header_size() +
+    slot_size * slab->num_handed_out++;
+    *reinterpret_cast<Slab**>(slot) = slab;
+    ptr = slot + slot_header_size;
+  }
+  if (++slab->num_allocated == slab_capacity) {
+    unlink_with_room(slab);
+  }
+  ++num_allocated;
+  return ptr;
+}
+
+// A slab that empties is kept if there is no empty slab already, and released if
+// there is.
+void Slab_pool::return_slot(void* ptr) noexcept {
+  Slab* slab = *reinterpret_cast<Slab**>(static_cast<char*>(ptr) - slot_header_size);
+  bool had_room = slab->num_allocated < slab_capacity;
+  --num_allocated;
+  *static_cast<void**>(ptr) = slab->free_list;
+  slab->free_list = ptr;
+  if (--slab->num_allocated == 0) {
+    if (had_room) {
+      unlink_with_room(slab);
+    }
+    if (spare_slab) {
+      release_slab(slab);
+    }
+    else {
+      spare_slab = slab;
+    }
+  }
+  else if (!had_room) {
+    link_with_room(slab);
+  }
+}
+
+Slab_pool::Slab* Slab_pool::make_slab() {
+  Slab* slab = new (::operator new(slab_header_size() + slot_size * slab_capacity)) Slab;
+  slab->next = first_slab;
+  if (first_slab) {
+    first_slab->prev = slab;
+  }
+  first_slab = slab;
+  ++num_slabs;
+  return slab;
+}
+
+void Slab_pool::release_slab(Slab* slab) noexcept {
+  if (slab->prev) {
+    slab->prev->next = slab->next;
+  }
+  else {
+    first_slab = slab->next;
+  }
+  if (slab->next) {
+    slab->next->prev = slab->prev;
+  }
+  --num_slabs;
+  ::operator delete(slab);
+}
+
+void Slab_pool::link_with_room(Slab* slab) {
+  slab->prev_with_room = nullptr;
+  slab->next_with_room = first_with_room;
+  if (first_with_room) {
+    first_with_room->prev_with_room = slab;
+  }
+  first_with_room = slab;
+}
+
+void Slab_pool::unlink_with_room(Slab* slab) {
+  if (slab->prev_with_room) {
+    slab->prev_with_room->next_with_room = slab->next_with_room;
+  }
+  else {
+    first_with_room = slab->next_with_room;
+  }
+  if (slab->next_with_room) {
+    slab->next_with_room->prev_with_room = slab->prev_with_room;
+  }
+  slab->prev_with_room = slab->next_with_room = nullptr;
+}
+
+// The oldest slots are handed back, and the most recently freed ones kept for reuse.
+void Slab_pool::give_back(Thread_cache& cache, int num_slots) noexcept {
+  lock_guard<mutex> lock(pool_mutex);
+  for (int i = 0; i < num_slots; i++) {
+    return_slot(cache.slots[i]);
+  }
+  copy(cache.slots + num_slots, cache.slots + cache.num_slots, cache.slots);
+  cache.num_slots -= num_slots;
+}
@@ -0,0 +1,105 @@
+//
+//  Slab_pool.h
+//  Project3
+//
+
+#ifndef SLAB_POOL_H
+#define SLAB_POOL_H
+#include <cstddef>
+#include <mutex>
+
+/* A Slab_pool hands out memory for objects of one size from large slabs, each
+ holding slab_capacity of them. An object never moves once allocated, so pointers
+ to it stay valid. Each slot starts with a pointer to its slab, so the slab of an
+ object being freed is found without a search.
+
+ Each thread keeps a small cache of free slots, so that most allocations and
+ deallocations take no lock: an empty cache takes a batch of slots from the slabs,
+ and a full one hands its older half back. A slot handed back goes on its slab's
+ free list. New slots come from a slab that already has objects in it before an
+ empty one is used, and a slab is released as a whole once its last object is
+ freed - except that one empty slab is kept, so that adding and deleting objects
+ by turns doesn't make and release a slab each time. deallocate_all hands back
+ many objects at once under one lock, releasing their slabs as they empty.
+
+ A thread's cache holds the slots of the last pool it used, so a thread that
+ switches between pools hands its cache back each time. A pool must outlive the
+ threads that use it, and must not be used while static objects are destroyed. */
+class Slab_pool {
+public:
+  // Create a pool for objects of object_size_ bytes, aligned to object_alignment,
+  // which can be no more than alignof(std::max_align_t), slab_capacity_ to a slab.
+  Slab_pool(std::size_t object_size_, std::size_t object_alignment, int slab_capacity_);
+  // Release all the slabs, whether or not their objects have been freed.
+  ~Slab_pool();
+
+  Slab_pool(const Slab_pool&) = delete;
+  Slab_pool& operator= (const Slab_pool&) = delete;
+
+  // Return memory for one object, making a new slab if none has room.
+  void* allocate();
+  // Return the memory of an object to the pool. ptr must have come from allocate;
+  // a null pointer is ignored.
+  void deallocate(void* ptr) noexcept;
+  // Return the memory of the objects pointed to in [first, last) straight to their
+  // slabs under one lock, releasing each slab that empties except the one kept.
+  // Null pointers are ignored.
+  template<typename Ptr_it>
+  void deallocate_all(Ptr_it first, Ptr_it last) noexcept {
+    std::lock_guard<std::mutex> lock(pool_mutex);
+    for (; first != last; ++first) {
+      if (*first) {
+        return_slot(*first);
+      }
+    }
+  }
+
+  // the number of slabs, and the number of objects allocated in them; slots in
+  // another thread's cache count as allocated until that thread hands them back
+  int get_num_slabs() const;
+  int get_num_allocated() const;
+  int get_slab_capacity() const
+		{return slab_capacity;}
+
+private:
+  struct Slab {
+    void* free_list = nullptr;    // freed slots, each holding the address of the next
+    int num_handed_out = 0;       // slots from the start of the slab ever handed out
+    int num_allocated = 0;        // including the slots in threads' caches
+    // all the slabs are kept in one list, and those with room for another object
+    // in another
+    Slab* prev = nullptr;
+    Slab* next = nullptr;
+    Slab* prev_with_room = nullptr;
+    Slab* next_with_room = nullptr;
+  };
+  struct Thread_cache;
+
+  // the calling thread's cache, whichever pool it belongs to
+  static Thread_cache& this_thread_cache();
+  // the calling thread's cache, handed back to its pool first if it is another one
+  Thread_cache& get_thread_cache();
+  // the size of the Slab at the start of a slab's memory, before the slots
+  static std::size_t slab_header_size();
+  // these must be called with pool_mutex locked
+  void* take_slot();
+  void return_slot(void* ptr) noexcept;
+  Slab* make_slab();
+  void release_slab(Slab* slab) noexcept;
+  void link_with_room(Slab* slab);
+  void unlink_with_room(Slab* slab);
+  // hand back the first num_slots slots in cache, locking pool_mutex
+  void give_back(Thread_cache& cache, int num_slots) noexcept;
+
+  const std::size_t slot_header_size;   // the slab pointer before each object
+  const std::size_t slot_size;
+  const int slab_capacity;
+  Slab* first_slab = nullptr;
+  Slab* first_with_room = nullptr;
+  Slab* spare_slab = nullptr;           // the empty slab that is kept
+  int num_slabs = 0;
+  int num_allocated = 0;
+  mutable std::mutex pool_mutex;
+};
+
+#endif
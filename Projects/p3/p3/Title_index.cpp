@@ -0,0 +1,153 @@
+//
+//  Title_index.cpp
+//  Project3
+//
+
+#include "Title_index.h"
+#include "Record.h"
+#include <algorithm>
+#include <cctype>
+#include <iterator>
+using namespace std;
+
+// compare characters the way a lower cased copy of both strings would
+static bool equal_ignoring_case(char lhs, char rhs) {
+  return tolower(static_cast<unsigned char>(lhs)) ==
+  tolower(static_cast<unsigned char>(rhs));
+}
+
+// true if the key appears in the title, ignoring case; no copies are made
+static bool title_contains(const Record* rec_ptr, const string& key) {
+  const string& title = rec_ptr->get_title();
+  return search(title.begin(), title.end(), key.begin(), key.end(),
+                equal_ignoring_case) != title.end();
+}
+
+// Add the Record under each trigram in its title.
+void Title_index::insert(const Record* rec_ptr) {
+  int id = rec_ptr->get_ID();
+  for (Trigram_t trigram : get_trigrams(rec_ptr->get_title())) {
+    Posting_list_t& posting_list = postings[trigram];
+    // new records have the highest ID so far, so this is almost always the end
+    auto it = lower_bound(posting_list.begin(), posting_list.end(), id);
+    if (it == posting_list.end() || *it != id) {
+      posting_list.insert(it, id);
+    }
+  }
+}
+
+// Replace the posting lists with ones for the supplied Records, in ID order.
+void Title_index::rebuild(const vector<Record*>& library_id) {
+  decltype(postings) new_postings;
+  for (const Record* rec_ptr : library_id) {
+    for (Trigram_t trigram : get_trigrams(rec_ptr->get_title())) {
+      new_postings[trigram].push_back(rec_ptr->get_ID());
+    }
+  }
+  // nothing changes unless all of the lists could be built
+  postings.swap(new_postings);
+}
+
+// Remove the Record from the posting lists of each trigram in its title.
+void Title_index::remove(const Record* rec_ptr) {
+  int id = rec_ptr->get_ID();
+  for (Trigram_t trigram : get_trigrams(rec_ptr->get_title())) {
+    auto map_it = postings.find(trigram);
+    if (map_it == postings.end()) {
+      continue;
+    }
+    Posting_list_t& posting_list = map_it->second;
+    auto it = lower_bound(posting_list.begin(), posting_list.end(), id);
+    if (it != posting_list.end() && *it == id) {
+      posting_list.erase(it);
+    }
+    // don't keep empty lists around for trigrams no title has any more
+    if (posting_list.empty()) {
+      postings.erase(map_it);
+    }
+  }
+}
+
+/* Return the Records in the library whose titles contain the key, ignoring case,
+ in title order. */
+vector<Record*> Title_index::find(const string& key,
+                                  const vector<Record*>& library_title,
+                                  const vector<Record*>& library_id) const {
+  vector<Trigram_t> trigrams = get_trigrams(key);
+  if (trigrams.empty()) {
+    return scan(key, library_title);
+  }
+  // every trigram of the key must be present, or no title can contain it
+  vector<const Posting_list_t*> posting_lists;
+  for (Trigram_t trigram : trigrams) {
+    auto map_it = postings.find(trigram);
+    if (map_it == postings.end()) {
+      return vector<Record*>();
+    }
+    posting_lists.push_back(&map_it->second);
+  }
+  // intersect starting from the shortest list, so the candidates only shrink
+  sort(posting_lists.begin(), posting_lists.end(),
+       [](const Posting_list_t* lhs, const Posting_list_t* rhs) {
+         return lhs->size() < rhs->size();
+       });
+  Posting_list_t candidates(*posting_lists.front());
+  for (auto list_it = posting_lists.begin() + 1;
+       list_it != posting_lists.end() && !candidates.empty(); ++list_it) {
+    const Posting_list_t& posting_list = **list_it;
+    // both are in ID order, so each search starts where the last one stopped
+    auto search_it = posting_list.begin();
+    auto new_end = remove_if(candidates.begin(), candidates.end(),
+                             [&search_it, &posting_list](int id) {
+      search_it = lower_bound(search_it, posting_list.end(), id);
+      return search_it == posting_list.end() || *search_it != id;
+    });
+    candidates.erase(new_end, candidates.end());
+  }
+  // having all the trigrams doesn't mean having them in a row, so check each title
+  vector<Record*> matching_rec_ptrs;
+  auto rec_it = library_id.begin();
+  for (int id : candidates) {
+    rec_it = lower_bound(rec_it, library_id.end(), id,
+                         [](const Record* rec_ptr, int id_) {
+                           return rec_ptr->get_ID() < id_;
+                         });
+    if (title_contains(*rec_it, key)) {
+      matching_rec_ptrs.push_back(*rec_it);
+    }
+  }
+  sort(matching_rec_ptrs.begin(), matching_rec_ptrs.end(),
+       [](const Record* lhs, const Record* rhs) {return *lhs < *rhs;});
+  return matching_rec_ptrs;
+}
+
+// Return the Records in library_title whose titles contain the key, ignoring case.
+vector<Record*> Title_index::scan(const string& key,
+                                  const vector<Record*>& library_title) {
+  vector<Record*> matching_rec_ptrs;
+  copy_if(library_title.begin(), library_title.end(),
+          back_inserter(matching_rec_ptrs),
+          [&key](const Record* rec_ptr) {return title_contains(rec_ptr, key);});
+  return matching_rec_ptrs;
+}
+
+// Return the distinct trigrams of the string, in increasing order.
+vector<Title_index::Trigram_t> Title_index::get_trigrams(const string& str) {
+  vector<Trigram_t> trigrams;
+  if (str.size() < 3) {
+    return trigrams;
+  }
+  trigrams.reserve(str.size() - 2);
+  Trigram_t trigram = 0;
+  for (size_t i = 0; i < str.size(); i++) {
+    // shift each lower cased character in, keeping the last three
+    Trigram_t c = static_cast<Trigram_t>(tolower(static_cast<unsigned char>(str[i])));
+    trigram = ((trigram << 8) | c) & 0xffffff;
+    if (i >= 2) {
+      trigrams.push_back(trigram);
+    }
+  }
+  sort(trigrams.begin(), trigrams.end());
+  trigrams.erase(unique(trigrams.begin(), trigrams.end()), trigrams.end());
+  return trigrams;
+}
@@ -0,0 +1,63 @@
+//
+//  Title_index.h
+//  Project3
+//
+
+#ifndef TITLE_INDEX_H
+#define TITLE_INDEX_H
+#include "Record.h"
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+class Title_index {
+  /* A Title_index is a case-insensitive inverted index over record titles. Each
+   trigram (three consecutive characters, lower cased) that appears in a title maps
+   to a posting list: the IDs of the records whose titles contain it, in increasing
+   order. A search string of three or more characters can only be contained in a
+   title that has all of the search string's trigrams, so intersecting their posting
+   lists gives a small set of candidates that are then checked against the titles.
+   The index does not own the Records; the library it is kept for must add and
+   remove each Record here whenever it adds or removes one, or changes its title.
+   */
+public:
+  // Add the Record under each trigram in its title.
+  void insert(const Record* rec_ptr);
+  // Remove the Record from the posting lists of each trigram in its title. The title
+  // must be the same as when the Record was inserted.
+  void remove(const Record* rec_ptr);
+  // Replace the posting lists with ones for the supplied Records, which must be in
+  // ID order. This is much faster than inserting them one at a time in any other
+  // order, since each ID is then added at the end of its posting lists.
+  void rebuild(const std::vector<Record*>& library_id);
+  // discard all posting lists
+  void clear()
+		{postings.clear();}
+  // exchange the contents with another index, without copying them
+  void swap(Title_index& other) noexcept
+		{postings.swap(other.postings);}
+
+  /* Return the Records in the library whose titles contain the key, ignoring case,
+   in title order. library_title and library_id must be the Records that have been
+   inserted, in title and in ID order. A key shorter than a trigram can't be looked
+   up in the index, so the titles in library_title are searched instead. */
+  std::vector<Record*> find(const std::string& key,
+                            const std::vector<Record*>& library_title,
+                            const std::vector<Record*>& library_id) const;
+
+  // Return the Records in library_title whose titles contain the key, ignoring case,
+  // by checking every title. This gives the same result as find.
+  static std::vector<Record*> scan(const std::string& key,
+                                   const std::vector<Record*>& library_title);
+
+private:
+  typedef std::uint32_t Trigram_t;
+  typedef std::vector<int> Posting_list_t;
+  std::unordered_map<Trigram_t, Posting_list_t> postings;
+
+  // Return the distinct trigrams of the string, in increasing order.
+  static std::vector<Trigram_t> get_trigrams(const std::string& str);
+};
+
+#endif
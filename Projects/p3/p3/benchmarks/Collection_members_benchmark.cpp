@@ -0,0 +1,135 @@
+/*
+ This is a benchmark of reading the members of large p3 Collections.
+
+ Two Collections are made from a library of records: one with every record as a
+ member, and one with every other record. For each, it reports the heap allocations
+ and the time in milliseconds for:
+   walk - visiting every member through get_members, as the statistics checker does
+   pc - outputting the Collection, as the pc command does, to a stream that
+        discards its output
+   cs - reading the three collection statistics, as the cs command does
+   recount - recomputing the statistics from the members of both Collections, as
+        the statistics checker does
+
+ Build it with "make cmbenchexe" in this directory.
+ Run it, optionally with the number of records, e.g. "cmbenchexe 1000000".
+ By default there are 100000 records.
+ */
+#include "../Record.h"
+#include "../Collection.h"
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <cstdlib>
+#include <map>
+#include <new>
+#include <string>
+#include <vector>
+using namespace std;
+
+// Heap allocations so far, counted by the replacement operator new below.
+static long g_allocations = 0;
+
+void* operator new(size_t size) {
+  ++g_allocations;
+  void* ptr = malloc(size ? size : 1);
+  if (!ptr) {
+    throw bad_alloc();
+  }
+  return ptr;
+}
+
+void operator delete(void* ptr) noexcept {
+  free(ptr);
+}
+
+void operator delete(void* ptr, size_t) noexcept {
+  free(ptr);
+}
+
+// a stream buffer that discards everything written to it
+class Null_buffer : public streambuf {
+protected:
+  int overflow(int c) override {
+    return c;
+  }
+  streamsize xsputn(const char*, streamsize n) override {
+    return n;
+  }
+};
+
+// milliseconds since the supplied start time
+static double elapsed_ms(chrono::steady_clock::time_point start) {
+  return chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+}
+
+// Time the function and count its allocations, repeated to get a measurable time.
+template<typename F>
+static void report(const char* name, const string& col_name, int repetitions, F function) {
+  long allocations = g_allocations;
+  auto start = chrono::steady_clock::now();
+  for (int r = 0; r < repetitions; r++) {
+    function();
+  }
+  double ms = elapsed_ms(start) / repetitions;
+  double allocations_per_call = double(g_allocations - allocations) / repetitions;
+  cout << setw(10) << name << setw(8) << col_name << setw(14) << allocations_per_call <<
+  setw(12) << ms << endl;
+}
+
+int main(int argc, char* argv[]) {
+  int size = argc > 1 ? atoi(argv[1]) : 100000;
+  vector<Record*> library;
+  for (int i = 0; i < size; i++) {
+    library.push_back(new Record("DVD", "Title " + to_string(i)));
+  }
+  Collection all("all");
+  Collection half("half");
+  for (int i = 0; i < size; i++) {
+    all.add_member(library[i]);
+    if (i % 2 == 0) {
+      half.add_member(library[i]);
+    }
+  }
+  Null_buffer null_buffer;
+  ostream null_stream(&null_buffer);
+  const int repetitions = 10;
+  cout << fixed << setprecision(2);
+  cout << size << " records" << endl;
+  cout << setw(10) << "operation" << setw(8) << "col" << setw(14) << "allocations" <<
+  setw(12) << "ms" << endl;
+  for (const Collection* col_ptr : {&all, &half}) {
+    const Collection& col = *col_ptr;
+    long sum = 0;
+    report("walk", col.get_name(), repetitions, [&col, &sum]() {
+      for (const Record* rec_ptr : col.get_members()) {
+        sum += rec_ptr->get_ID();
+      }
+    });
+    report("pc", col.get_name(), repetitions, [&col, &null_stream]() {
+      null_stream << col;
+    });
+    report("cs", col.get_name(), repetitions, [&sum]() {
+      sum += Collection::get_num_records_in_any() +
+      Collection::get_num_records_in_many() + Collection::get_num_memberships();
+    });
+    // keep the compiler from discarding the loops
+    if (sum == 42) {
+      cout << sum << endl;
+    }
+  }
+  report("recount", "both", repetitions, [&all, &half]() {
+    map<int, int> num_collections;
+    for (const Collection* col_ptr : {&all, &half}) {
+      for (const Record* rec_ptr : col_ptr->get_members()) {
+        ++num_collections[rec_ptr->get_ID()];
+      }
+    }
+  });
+  all.clear();
+  half.clear();
+  for (Record* rec_ptr : library) {
+    delete rec_ptr;
+  }
+  return 0;
+}
@@ -0,0 +1,126 @@
+/*
+ This is a benchmark of the Flat_set that holds the members of a p3 Collection,
+ against the std::set of Record pointers that Collections used before.
+
+ For each size from 1000 up, it makes a library of three times that many records
+ and two sets: one of the records with even numbers, and one of those with numbers
+ divisible by three, so that they overlap. It reports the heap bytes per member, and
+ the time to combine the two sets as the cc command does, in milliseconds and in
+ millions of members combined per second. The std::set is combined the way
+ Collection used to do it: a copy of the first set, then each member of the second
+ inserted after checking whether it is present. The Flat_set is combined with a
+ single merge into exactly the space needed.
+
+ Build it with "make msbenchexe" in this directory.
+ Run it, optionally with the largest size, e.g. "msbenchexe 10000000".
+ By default the sizes go up to 1000000.
+ */
+#include "../Record.h"
+#include "../Collection.h"
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+#include <set>
+#include <string>
+#include <vector>
+using namespace std;
+
+typedef set<Record*, Title_less_ptr> Tree_set_t;
+
+// Heap bytes currently in use, kept up to date by the replacement operator new
+// and delete below, which store the size of each block just in front of it.
+static size_t g_heap_bytes = 0;
+static const size_t heap_header_size = alignof(max_align_t);
+
+void* operator new(size_t size) {
+  void* raw_ptr = malloc(size + heap_header_size);
+  if (!raw_ptr) {
+    throw bad_alloc();
+  }
+  *static_cast<size_t*>(raw_ptr) = size;
+  g_heap_bytes += size;
+  return static_cast<char*>(raw_ptr) + heap_header_size;
+}
+
+void operator delete(void* ptr) noexcept {
+  if (ptr) {
+    void* raw_ptr = static_cast<char*>(ptr) - heap_header_size;
+    g_heap_bytes -= *static_cast<size_t*>(raw_ptr);
+    free(raw_ptr);
+  }
+}
+
+void operator delete(void* ptr, size_t) noexcept {
+  operator delete(ptr);
+}
+
+// milliseconds since the supplied start time
+static double elapsed_ms(chrono::steady_clock::time_point start) {
+  return chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+}
+
+// Fill the sets with every step'th record, and return the heap bytes they take.
+template<typename S>
+static size_t fill(S& members, const vector<Record*>& library, int step) {
+  size_t heap_bytes = g_heap_bytes;
+  for (size_t i = 0; i < library.size(); i += step) {
+    members.insert(library[i]);
+  }
+  return g_heap_bytes - heap_bytes;
+}
+
+int main(int argc, char* argv[]) {
+  int largest_size = argc > 1 ? atoi(argv[1]) : 1000000;
+  cout << fixed << setprecision(2);
+  cout << setw(10) << "size" << setw(12) << "tree B/m" << setw(12) << "flat B/m" <<
+  setw(12) << "tree cc ms" << setw(12) << "flat cc ms" << setw(12) << "tree M/s" <<
+  setw(12) << "flat M/s" << endl;
+  for (int size = 1000; size <= largest_size; size *= 10) {
+    // the record numbers are padded so that title order is numeric order
+    vector<Record*> library;
+    for (int i = 0; i < 3 * size; i++) {
+      string number = to_string(i);
+      library.push_back(new Record("DVD", "Title " + string(8 - number.size(), '0') + number));
+    }
+    Tree_set_t tree_evens, tree_threes;
+    Record_set_t flat_evens, flat_threes;
+    size_t tree_bytes = fill(tree_evens, library, 2) + fill(tree_threes, library, 3);
+    size_t flat_bytes = fill(flat_evens, library, 2) + fill(flat_threes, library, 3);
+    double num_members = double(tree_evens.size() + tree_threes.size());
+    // fewer repetitions for the larger sets keep the run time reasonable
+    int repetitions = max(1, 10000000 / size);
+    size_t combined_size = 0;
+    auto start = chrono::steady_clock::now();
+    for (int r = 0; r < repetitions; r++) {
+      Tree_set_t combined(tree_evens);
+      for (Record* rec_ptr : tree_threes) {
+        if (combined.find(rec_ptr) == combined.end()) {
+          combined.insert(rec_ptr);
+        }
+      }
+      combined_size += combined.size();
+    }
+    double tree_ms = elapsed_ms(start) / repetitions;
+    start = chrono::steady_clock::now();
+    for (int r = 0; r < repetitions; r++) {
+      Record_set_t combined(flat_evens, flat_threes);
+      combined_size -= combined.size();
+    }
+    double flat_ms = elapsed_ms(start) / repetitions;
+    cout << setw(10) << size << setw(12) << tree_bytes / num_members <<
+    setw(12) << flat_bytes / num_members << setw(12) << tree_ms << setw(12) << flat_ms <<
+    setw(12) << num_members / tree_ms / 1000. << setw(12) << num_members / flat_ms / 1000. <<
+    endl;
+    if (combined_size) {
+      cout << "the combined sets differ in size" << endl;
+      return 1;
+    }
+    for (Record* rec_ptr : library) {
+      delete rec_ptr;
+    }
+  }
+  return 0;
+}
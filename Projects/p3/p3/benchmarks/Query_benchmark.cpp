@@ -0,0 +1,111 @@
+/*
+ This is a benchmark of answering qr queries from Record_columns, compared with
+ scanning the library and looking at each Record through its pointer.
+
+ It makes a library of records with a mix of media and ratings, kept in title
+ order as the p3 library is, and the columns for it. Then it answers the query
+ "rating >= 4 and medium = DVD" and counts the records with each rating, first by
+ following each pointer in the library, and then by scanning the columns. Each is
+ repeated a few times and the best time is reported, and the answers are checked
+ against each other.
+
+ Build it with "make querybenchexe" in this directory.
+ Run it, optionally with the number of records, e.g. "querybenchexe 1000000".
+ By default there are 10000000 records, which takes over a gigabyte of memory.
+ */
+#include "../Record.h"
+#include "../Record_columns.h"
+#include <iostream>
+#include <iomanip>
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <string>
+#include <vector>
+using namespace std;
+
+// each way of answering is repeated this many times
+static const int num_repeats = 5;
+
+// seconds since the supplied start time
+static double elapsed_s(chrono::steady_clock::time_point start) {
+  return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+// the least time any of the repeats of the function took, in milliseconds
+template<typename F>
+static double best_ms(F function) {
+  double best = 0;
+  for (int i = 0; i < num_repeats; i++) {
+    auto start = chrono::steady_clock::now();
+    function();
+    double seconds = elapsed_s(start);
+    if (i == 0 || seconds < best) {
+      best = seconds;
+    }
+  }
+  return best * 1000;
+}
+
+int main(int argc, char* argv[]) {
+  int size = argc > 1 ? atoi(argv[1]) : 10000000;
+  const char* const media[] = {"DVD", "CD", "VHS", "BluRay"};
+  // the titles are short enough to be kept inside the strings, and scrambled so
+  // that title order is not the order the Records were made in
+  vector<Record*> library_id;
+  library_id.reserve(size);
+  for (int i = 0; i < size; i++) {
+    uint32_t scrambled = uint32_t(i) * 2654435761u;
+    library_id.push_back(new Record(media[i % 4], "t" + to_string(scrambled)));
+    if (i % 6) {
+      library_id.back()->set_rating(i % 6);
+    }
+  }
+  vector<Record*> library_title(library_id);
+  sort(library_title.begin(), library_title.end(), [](const Record* lhs, const Record* rhs) {
+    return *lhs < *rhs;});
+  Record_columns columns;
+  columns.rebuild(library_id);
+
+  int pointer_count = 0, column_count = 0;
+  vector<int> pointer_counts, column_counts;
+  double pointer_ms = best_ms([&]() {
+    pointer_count = 0;
+    for (const Record* rec_ptr : library_title) {
+      pointer_count += rec_ptr->get_rating() >= 4 && rec_ptr->get_medium() == "DVD";
+    }
+  });
+  double column_ms = best_ms([&]() {
+    Record_columns::Selection_t selection = columns.select_all();
+    columns.restrict(selection, Record_columns::RATING_FIELD, Record_columns::GREATER_EQUAL, 4);
+    columns.restrict(selection, Record_columns::MEDIUM_FIELD, Record_columns::EQUAL,
+                     columns.get_medium_code("DVD"));
+    column_count = columns.count(selection);
+  });
+  double pointer_histogram_ms = best_ms([&]() {
+    pointer_counts.assign(6, 0);
+    for (const Record* rec_ptr : library_title) {
+      ++pointer_counts[rec_ptr->get_rating()];
+    }
+  });
+  double column_histogram_ms = best_ms([&]() {
+    column_counts = columns.count_by_rating(columns.select_all());
+  });
+
+  cout << fixed << setprecision(1);
+  cout << size << " records" << endl;
+  cout << setw(36) << "query" << setw(12) << "pointers" << setw(12) << "columns" << endl;
+  cout << setw(36) << "count rating >= 4 and medium = DVD" << setw(10) << pointer_ms << "ms"
+  << setw(10) << column_ms << "ms" << endl;
+  cout << setw(36) << "histogram" << setw(10) << pointer_histogram_ms << "ms"
+  << setw(10) << column_histogram_ms << "ms" << endl;
+  if (pointer_count != column_count || pointer_counts != column_counts) {
+    cout << "the answers from the columns differ from those from the pointers" << endl;
+    return 1;
+  }
+  for (Record* rec_ptr : library_id) {
+    delete rec_ptr;
+  }
+  return 0;
+}
@@ -0,0 +1,132 @@
+/*
+ This is a benchmark of reading the records of a large p3 save file with
+ restore_records_in_parallel, as the rA command does.
+
+ It saves a library of records to a file, and reads the records back first the way
+ rA used to: a record at a time with Record(ifstream&), each inserted at its lower
+ bound by title. Then it reads them with restore_records_in_parallel using 1, 2, 4,
+ ... threads, up to twice the number of hardware threads, and checks that each
+ library is the same as the first. It reports the throughput of each read in
+ megabytes per second, including opening the file.
+
+ Build it with "make restorebenchexe" in this directory.
+ Run it, optionally with the number of records and the file to save to, e.g.
+ "restorebenchexe 5000000 /tmp/restore.txt". By default there are 1000000 records,
+ saved to restore_benchmark.txt, and the file is removed at the end.
+ */
+#include "../Record.h"
+#include "../Collection.h"
+#include "../Parallel_save.h"
+#include "../Parallel_restore.h"
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <vector>
+using namespace std;
+
+// seconds since the supplied start time
+static double elapsed_s(chrono::steady_clock::time_point start) {
+  return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+static void delete_records(vector<Record*>& library) {
+  for (Record* rec_ptr : library) {
+    delete rec_ptr;
+  }
+  library.clear();
+}
+
+// Read the records the way rA used to, one at a time.
+static vector<Record*> restore_one_at_a_time(const string& file_name) {
+  ifstream is(file_name.c_str());
+  int num_rec = 0;
+  is >> num_rec;
+  vector<Record*> library;
+  library.reserve(num_rec);
+  for (int i = 0; i < num_rec; i++) {
+    Record* rec_ptr = new Record(is);
+    library.insert(lower_bound(library.begin(), library.end(), rec_ptr,
+                               [](const Record* lhs, const Record* rhs) {return *lhs < *rhs;}),
+                   rec_ptr);
+  }
+  return library;
+}
+
+static vector<Record*> restore_in_parallel(const string& file_name, int num_threads) {
+  ifstream is(file_name.c_str());
+  int num_rec = 0;
+  is >> num_rec;
+  vector<Record*> library;
+  if (!restore_records_in_parallel(is, num_rec, library, num_threads)) {
+    cout << "the file was not in the usual form" << endl;
+    exit(1);
+  }
+  return library;
+}
+
+// the Records in save format
+static string saved_records(const vector<Record*>& library) {
+  ostringstream os;
+  for (const Record* rec_ptr : library) {
+    rec_ptr->save(os);
+  }
+  return os.str();
+}
+
+int main(int argc, char* argv[]) {
+  int size = argc > 1 ? atoi(argv[1]) : 1000000;
+  string file_name = argc > 2 ? argv[2] : "restore_benchmark.txt";
+  // the record numbers are padded so that title order is numeric order
+  vector<Record*> library;
+  for (int i = 0; i < size; i++) {
+    string number = to_string(i);
+    library.push_back(new Record("DVD", "A title of moderate length, number " +
+                                 string(9 - number.size(), '0') + number));
+    if (i % 3) {
+      library.back()->set_rating(1 + i % 5);
+    }
+  }
+  {
+    ofstream os(file_name.c_str());
+    save_in_parallel(os, library, vector<Collection>());
+  }
+  delete_records(library);
+  double megabytes = 0;
+  {
+    ifstream is(file_name.c_str(), ios::binary | ios::ate);
+    megabytes = is.tellg() / 1e6;
+  }
+
+  auto start = chrono::steady_clock::now();
+  vector<Record*> library_read = restore_one_at_a_time(file_name);
+  double seconds = elapsed_s(start);
+  string expected = saved_records(library_read);
+  delete_records(library_read);
+  cout << fixed << setprecision(1);
+  cout << size << " records, " << megabytes << " MB" << endl;
+  cout << setw(16) << "restore" << setw(10) << "MB/s" << endl;
+  cout << setw(16) << "one at a time" << setw(10) << megabytes / seconds << endl;
+  int max_threads = 2 * max(1, int(thread::hardware_concurrency()));
+  for (int num_threads = 1; num_threads <= max_threads; num_threads *= 2) {
+    start = chrono::steady_clock::now();
+    library = restore_in_parallel(file_name, num_threads);
+    seconds = elapsed_s(start);
+    cout << setw(8) << num_threads << " threads" << setw(10) << megabytes / seconds << endl;
+    if (saved_records(library) != expected) {
+      cout << "the records differ from those read one at a time" << endl;
+      return 1;
+    }
+    delete_records(library);
+  }
+  if (argc <= 2) {
+    remove(file_name.c_str());
+  }
+  return 0;
+}
@@ -0,0 +1,116 @@
+/*
+ This is a benchmark of saving a large p3 library and catalog with save_in_parallel,
+ as the sA command does.
+
+ It makes a library of records and a catalog of collections of them, and saves
+ them to a file first the way sA used to: each line written to the file stream
+ and flushed. Then it saves them with save_in_parallel using 1, 2, 4, ... threads,
+ up to twice the number of hardware threads, and checks that each file is the same
+ as the first. It reports the throughput of each save in megabytes per second,
+ including opening and closing the file.
+
+ Build it with "make savebenchexe" in this directory.
+ Run it, optionally with the number of records and the file to save to, e.g.
+ "savebenchexe 5000000 /tmp/save.txt". By default there are 1000000 records,
+ saved to save_benchmark.txt, and the file is removed at the end.
+ */
+#include "../Record.h"
+#include "../Collection.h"
+#include "../Parallel_save.h"
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <vector>
+using namespace std;
+
+// seconds since the supplied start time
+static double elapsed_s(chrono::steady_clock::time_point start) {
+  return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+// Save the way sA used to, flushing after every line as endl did.
+static void save_flushing_each_line(ostream& os, const vector<Record*>& library,
+                                    const vector<Collection>& catalog) {
+  os << library.size() << endl;
+  for (const Record* rec_ptr : library) {
+    rec_ptr->save(os);
+    os.flush();
+  }
+  os << catalog.size() << endl;
+  for (const Collection& col : catalog) {
+    os << col.get_name() << " " << col.get_members().size() << endl;
+    for (const Record* rec_ptr : col.get_members()) {
+      os << rec_ptr->get_title() << endl;
+    }
+  }
+}
+
+// the contents of the file
+static string read_file(const string& file_name) {
+  ifstream is(file_name.c_str(), ios::binary);
+  return string(istreambuf_iterator<char>(is), istreambuf_iterator<char>());
+}
+
+int main(int argc, char* argv[]) {
+  int size = argc > 1 ? atoi(argv[1]) : 1000000;
+  string file_name = argc > 2 ? argv[2] : "save_benchmark.txt";
+  // the record numbers are padded so that title order is numeric order
+  vector<Record*> library;
+  for (int i = 0; i < size; i++) {
+    string number = to_string(i);
+    library.push_back(new Record("DVD", "A title of moderate length, number " +
+                                 string(9 - number.size(), '0') + number));
+    if (i % 3) {
+      library.back()->set_rating(1 + i % 5);
+    }
+  }
+  // a hundred small collections, and two large ones
+  vector<Collection> catalog;
+  for (int c = 0; c < 102; c++) {
+    catalog.push_back(Collection("collection" + to_string(100 + c)));
+    int step = c < 100 ? max(1, size / 100) : 2 + c % 2;
+    for (int i = c % step; i < size; i += step) {
+      catalog.back().add_member(library[i]);
+    }
+  }
+
+  auto start = chrono::steady_clock::now();
+  {
+    ofstream os(file_name.c_str());
+    save_flushing_each_line(os, library, catalog);
+  }
+  double seconds = elapsed_s(start);
+  string expected = read_file(file_name);
+  double megabytes = expected.size() / 1e6;
+  cout << fixed << setprecision(1);
+  cout << size << " records, " << megabytes << " MB" << endl;
+  cout << setw(16) << "save" << setw(10) << "MB/s" << endl;
+  cout << setw(16) << "flush each line" << setw(10) << megabytes / seconds << endl;
+  int max_threads = 2 * max(1, int(thread::hardware_concurrency()));
+  for (int num_threads = 1; num_threads <= max_threads; num_threads *= 2) {
+    start = chrono::steady_clock::now();
+    {
+      ofstream os(file_name.c_str());
+      save_in_parallel(os, library, catalog, num_threads);
+    }
+    seconds = elapsed_s(start);
+    cout << setw(8) << num_threads << " threads" << setw(10) << megabytes / seconds << endl;
+    if (read_file(file_name) != expected) {
+      cout << "the file differs from the one saved a line at a time" << endl;
+      return 1;
+    }
+  }
+  if (argc <= 2) {
+    remove(file_name.c_str());
+  }
+  catalog.clear();
+  for (Record* rec_ptr : library) {
+    delete rec_ptr;
+  }
+  return 0;
+}
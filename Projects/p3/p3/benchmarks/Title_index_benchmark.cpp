@@ -0,0 +1,113 @@
+/*
+ This is a benchmark of the Title_index used by the p3 fs command.
+
+ For libraries from 1000 records up, it times each of a set of search strings with
+ Title_index::find, in microseconds per query, next to Title_index::scan, which
+ checks every title the way fs used to. The titles are made up of words drawn at
+ random from a small vocabulary, so some search strings match many titles, some
+ match few, and some have all their trigrams in a title without matching it. Each
+ find is checked against the scan, so a wrong answer is reported as well.
+
+ Build it with "make tibenchexe" in this directory.
+ Run it, optionally with the largest library size, e.g. "tibenchexe 10000000".
+ By default the libraries go up to 1000000 records.
+ */
+#include "../Record.h"
+#include "../Title_index.h"
+#include <iostream>
+#include <iomanip>
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <string>
+#include <vector>
+using namespace std;
+
+static const char* const vocabulary[] = {
+  "the", "of", "and", "night", "day", "war", "peace", "return", "king", "queen",
+  "river", "stone", "garden", "winter", "summer", "city", "house", "ghost", "story",
+  "song", "last", "first", "little", "great", "secret", "dark", "blue", "golden",
+  "wales", "contrib", "syzygy", "machine", "ocean", "island", "empire", "dream"
+};
+static const int vocabulary_size = sizeof(vocabulary) / sizeof(vocabulary[0]);
+
+// a mix of common, rare, absent, and short search strings
+static const char* const keys[] = {
+  "the", "GHOST", "syzygy", "night of", "er s", "xyz", "ue"
+};
+
+// a simple linear congruential generator so that runs are repeatable
+static int next_random(unsigned int& seed) {
+  seed = seed * 1103515245 + 12345;
+  return int((seed >> 8) & 0x7fffff);
+}
+
+// microseconds since the supplied start time
+static double elapsed_us(chrono::steady_clock::time_point start) {
+  return chrono::duration<double, micro>(chrono::steady_clock::now() - start).count();
+}
+
+// Make size records with distinct titles, in ID order.
+static vector<Record*> make_records(int size) {
+  unsigned int seed = 17;
+  vector<Record*> records;
+  records.reserve(size);
+  Record::reset_ID_counter();
+  for (int i = 0; i < size; i++) {
+    string title;
+    int num_words = 2 + next_random(seed) % 4;
+    for (int w = 0; w < num_words; w++) {
+      title += vocabulary[next_random(seed) % vocabulary_size];
+      title += ' ';
+    }
+    // the number keeps the titles distinct, as the library requires
+    title += to_string(i);
+    records.push_back(new Record("DVD", title));
+  }
+  return records;
+}
+
+int main(int argc, char* argv[]) {
+  int largest_size = argc > 1 ? atoi(argv[1]) : 1000000;
+  cout << fixed << setprecision(1);
+  cout << setw(10) << "size" << setw(12) << "key" << setw(10) << "matches" <<
+  setw(14) << "find us" << setw(14) << "scan us" << endl;
+  for (int size = 1000; size <= largest_size; size *= 10) {
+    vector<Record*> library_id = make_records(size);
+    vector<Record*> library_title = library_id;
+    sort(library_title.begin(), library_title.end(),
+         [](const Record* lhs, const Record* rhs) {return *lhs < *rhs;});
+    Title_index index;
+    auto start = chrono::steady_clock::now();
+    for (Record* rec_ptr : library_id) {
+      index.insert(rec_ptr);
+    }
+    cout << setw(10) << size << "  index built in " << elapsed_us(start) / 1000. <<
+    " ms" << endl;
+    // fewer repetitions for the larger libraries keep the run time reasonable
+    int repetitions = max(1, 1000000 / size);
+    for (const char* key : keys) {
+      vector<Record*> found, scanned;
+      start = chrono::steady_clock::now();
+      for (int r = 0; r < repetitions; r++) {
+        found = index.find(key, library_title, library_id);
+      }
+      double find_us = elapsed_us(start) / repetitions;
+      start = chrono::steady_clock::now();
+      for (int r = 0; r < repetitions; r++) {
+        scanned = Title_index::scan(key, library_title);
+      }
+      double scan_us = elapsed_us(start) / repetitions;
+      cout << setw(10) << size << setw(12) << key << setw(10) << found.size() <<
+      setw(14) << find_us << setw(14) << scan_us << endl;
+      if (found != scanned) {
+        cout << "find and scan disagree for " << key << endl;
+        return 1;
+      }
+    }
+    for (Record* rec_ptr : library_id) {
+      delete rec_ptr;
+    }
+  }
+  return 0;
+}
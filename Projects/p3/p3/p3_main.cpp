@@ -9,17 +9,28 @@
 #include "Utility.h"
 #include "Record.h"
 #include "Collection.h"
+#include "Title_index.h"
+#include "Rating_index.h"
+#include "Record_columns.h"
+#include "Parallel_save.h"
+#include "Parallel_restore.h"
+#include "Data_snapshot.h"
 #include <iostream>
 #include <fstream>
 #include <cctype>
+#include <cstdlib>
+#include <chrono>
 #include <algorithm>
 #include <functional>
+#include <future>
 #include <iterator>
+#include <sstream>
 #include <string>
 #include <vector>
 #include <map>
 #include <set>
 #include <list>
+#include <memory>
 #include <new>
 using namespace std;
 
@@ -34,10 +45,33 @@ using namespace std;
 typedef vector<Record*> Record_ptr_container_t;
 typedef vector<Collection> Collection_container_t;
 
+// a save going on on another thread, and the snapshot it is saving
+struct Background_save {
+  string file_name;
+  unique_ptr<Data_snapshot> snapshot;
+  // valid while there is a save in progress or not yet reported
+  future<void> done;
+};
+
 struct Data_container {
   Collection_container_t cat;
   Record_ptr_container_t lib_title;
   Record_ptr_container_t lib_id;
+  // kept in step with the libraries for fs, lr and qr
+  Title_index title_index;
+  Rating_index rating_index;
+  Record_columns columns;
+  // not part of the data, so swap leaves it alone
+  Background_save background_save;
+  // exchange all the data with another container, without copying any of it
+  void swap(Data_container& other) noexcept {
+    cat.swap(other.cat);
+    lib_title.swap(other.lib_title);
+    lib_id.swap(other.lib_id);
+    title_index.swap(other.title_index);
+    rating_index.swap(other.rating_index);
+    columns.swap(other.columns);
+  }
 };
 
 // internal helpers for main to delegate to the modules, const correctness
@@ -58,19 +92,31 @@ static void clear_library(Data_container&);
 static void clear_catalog(Data_container&);
 static void clear_all_data(Data_container&);
 static void save_all_data(const Data_container&);
+static void save_in_background(Data_container&);
+// reports a finished background save, waiting for it to finish first if wait is true
+static void report_background_save(Data_container&, bool wait);
 static void restore_all_data(Data_container&);
 static void find_with_string(const Data_container&);
 static void list_ratings(const Data_container&);
 static void collection_statistics(const Data_container&);
 static void combine_collections(Data_container&);
+#ifdef P3_CHECK_STATISTICS
+static void check_collection_statistics(const Data_container&);
+#endif
 static void modify_title(Data_container&);
+static void import_records(Data_container&);
+static void query_records(const Data_container&);
 
 static Record_ptr_container_t::iterator get_rec_it_by_title(Data_container&);
 static Record_ptr_container_t::iterator get_rec_it_by_id(Data_container&);
 static Collection_container_t::iterator get_col_it_by_name(Data_container&);
 static const Record* insert_record(Data_container&, Record*);
+// adds a record already in the libraries to the indexes and the columns
+static void index_record(Data_container&, const Record*);
 static void insert_collection(Data_container&, const Collection&&);
 static void clear_libraries(Data_container&);
+// discards what a failed restore has read, and restores the ID counter
+static void discard_staged_data(Data_container&);
 
 // reads and compresses bad titles and returns compacted title
 static string read_and_compact_title(istream& is);
@@ -84,6 +130,11 @@ static Collection_container_t::iterator cat_lower_bound(Data_container&,
                                                         const Collection&);
 
 static int read_integer();
+// reads one condition of a query, as in "rating >= 4", and narrows the selection
+static void restrict_query(const Data_container&, istream&, Record_columns::Selection_t&);
+// every record or collection in a save file takes at least this many bytes
+static const int min_saved_bytes = 4;
+static bool read_optional_integer(int&);
 
 int main(int argc, const char * argv[]) {
   Data_container dc;
@@ -108,12 +159,15 @@ int main(int argc, const char * argv[]) {
     {"cC", clear_catalog},
     {"cA", clear_all_data},
     {"sA", save_all_data},
+    {"sB", save_in_background},
     {"rA", restore_all_data},
     {"fs", find_with_string},
     {"lr", list_ratings},
     {"cs", collection_statistics},
     {"cc", combine_collections},
-    {"mt", modify_title}
+    {"mt", modify_title},
+    {"iL", import_records},
+    {"qr", query_records}
   };
   // {f,p,m,a,d,c,s,r}
   char actionLetter;
@@ -126,6 +180,7 @@ int main(int argc, const char * argv[]) {
       command += actionLetter;
       command += objectLetter;
       if (command == "qq") {
+        report_background_save(dc, true);
         clear_all_data(dc);
         cout << "Done" << endl;
         return 0;
@@ -149,13 +204,19 @@ int main(int argc, const char * argv[]) {
       cout << err.msg << endl;
     }
     catch (bad_alloc) {
+      dc.cat.clear();
       clear_libraries(dc);
       throw;
     }
     catch (...) {
+      dc.cat.clear();
       clear_libraries(dc);
       throw;
     }
+    report_background_save(dc, false);
+#ifdef P3_CHECK_STATISTICS
+    check_collection_statistics(dc);
+#endif
     printf("\nEnter command: ");
   } // while
   return 0;
@@ -201,6 +262,9 @@ static void print_allocation(const Data_container& dc) {
   cout << "Memory allocations:" << endl;
   cout << "Records: " << dc.lib_title.size() << endl;
   cout << "Collections: " << dc.cat.size() << endl;
+  const Slab_pool& pool = Record::get_pool();
+  cout << "Record slabs: " << pool.get_num_slabs() << " with " << pool.get_num_allocated()
+  << " of " << pool.get_num_slabs() * pool.get_slab_capacity() << " slots in use" << endl;
 }
 
 static void add_record(Data_container& dc) {
@@ -210,6 +274,7 @@ static void add_record(Data_container& dc) {
   check_empty_title(title);
   check_title_exist_in_lib(dc, title);
   const Record* rec_ptr = insert_record(dc, new Record(medium, title));
+  index_record(dc, rec_ptr);
   cout << "Record "<< rec_ptr->get_ID() << " added" << endl;
 }
 
@@ -233,7 +298,17 @@ static void add_member(Data_container& dc) {
 static void modify_rating(Data_container& dc) {
   Record* rec_ptr = *get_rec_it_by_id(dc);
   int rating = read_integer();
-  rec_ptr->set_rating(rating);
+  // the record moves to its new place in the rating index, or stays where it was
+  // if the rating is out of range
+  dc.rating_index.remove(rec_ptr);
+  try {
+    rec_ptr->set_rating(rating);
+  } catch (...) {
+    dc.rating_index.insert(rec_ptr);
+    throw;
+  }
+  dc.rating_index.insert(rec_ptr);
+  dc.columns.update_rating(rec_ptr);
   cout << "Rating for record " << rec_ptr->get_ID() <<  " changed to " << rating << endl;
 }
 
@@ -244,6 +319,9 @@ static void delete_record(Data_container& dc) {
     throw Error_no_clear("Cannot delete a record that is a member of a collection!");
   }
   auto rec_ptr = *it;
+  dc.title_index.remove(rec_ptr);
+  dc.rating_index.remove(rec_ptr);
+  dc.columns.remove(rec_ptr);
   dc.lib_title.erase(it);
   dc.lib_id.erase(lib_id_lower_bound(dc, rec_ptr));
   cout << "Record " << rec_ptr->get_ID() << " " << rec_ptr->get_title()
@@ -283,8 +361,9 @@ static void clear_catalog(Data_container& dc) {
 
 static void clear_all_data(Data_container& dc) {
   Record::reset_ID_counter();
-  clear_libraries(dc);
+  // collections go first, since they uncount their members in the records
   dc.cat.clear();
+  clear_libraries(dc);
   cout << "All data deleted" << endl;
 }
 
@@ -295,18 +374,59 @@ static void save_all_data(const Data_container& dc) {
   if(!saving_file) {
     throw Error("Could not open file!");
   }
-  saving_file << dc.lib_title.size() << endl;
-  // used 2 lambdas separately
-  for_each(dc.lib_title.begin(), dc.lib_title.end(), [&saving_file](Record* rec_ptr) {
-    rec_ptr->save(saving_file);
-  });
-  saving_file << dc.cat.size() << endl;
-  for_each(dc.cat.begin(), dc.cat.end(), [&saving_file](const Collection& col) {
-    col.save(saving_file);
-  });
+  // formatted in chunks by several threads, and written with a few large writes
+  save_in_parallel(saving_file, dc.lib_title, dc.cat);
   cout << "Data saved" << endl;
 }
 
+/* Saves the data as sA would at this moment, but on another thread, so that more
+ commands can be given while it is saved. A snapshot of the data is taken first,
+ which shares the library's columns rather than copying them, and the other thread
+ saves the snapshot, however the data is changed in the meantime. That the save has
+ finished is reported after the first command that finishes after it does. */
+static void save_in_background(Data_container& dc) {
+  Background_save& save = dc.background_save;
+  if (save.done.valid()) {
+    throw Error("A background save is already in progress!");
+  }
+  string file_name;
+  cin >> file_name;
+  ofstream saving_file(file_name.c_str());
+  if (!saving_file) {
+    throw Error("Could not open file!");
+  }
+  save.snapshot.reset(new Data_snapshot(dc.columns, dc.cat));
+  const Data_snapshot* snapshot_ptr = save.snapshot.get();
+  try {
+    save.done = async(launch::async, [snapshot_ptr](ofstream file) {
+      snapshot_ptr->save(file);
+    }, move(saving_file));
+  } catch (...) {
+    save.snapshot.reset();
+    throw;
+  }
+  save.file_name = file_name;
+  cout << "Background save to " << file_name << " started" << endl;
+}
+
+static void report_background_save(Data_container& dc, bool wait) {
+  Background_save& save = dc.background_save;
+  if (!save.done.valid() ||
+      (!wait && save.done.wait_for(chrono::seconds(0)) != future_status::ready)) {
+    return;
+  }
+  // get rethrows anything thrown by the save
+  try {
+    save.done.get();
+    cout << "Background save to " << save.file_name << " finished" << endl;
+  } catch (...) {
+    cout << "Background save to " << save.file_name << " failed" << endl;
+  }
+  // the snapshot is only destroyed here, so that its columns stop being shared on
+  // the thread that changes the live ones
+  save.snapshot.reset();
+}
+
 static void restore_all_data(Data_container& dc) {
   string file_name;
   cin >> file_name;
@@ -314,77 +434,83 @@ static void restore_all_data(Data_container& dc) {
   if(!restoring_file) {
     throw Error("Could not open file!");
   }
+  // the size of the file limits how many records and collections it can hold,
+  // so a corrupt count in it can't make the reservations below huge
+  restoring_file.seekg(0, ios::end);
+  streamoff max_num_saved = max<streamoff>(0, restoring_file.tellg()) / min_saved_bytes;
+  restoring_file.seekg(0);
+  restoring_file.clear();
   int num_rec = 0;
   if (!(restoring_file >> num_rec)) {
     throw_file_exception();
   }
-  // fresh containers
+  // everything is read into a staging container, and dc is only touched once
+  // all of it has been read successfully
   Data_container new_dc;
+  Record::save_ID_counter();
   try {
-    Record::save_ID_counter();
     Record::reset_ID_counter();
-    for (int i = 0; i < num_rec ; i++) {
-      insert_record(new_dc, new Record(restoring_file));
+    // a file in the usual one-record-per-line form is parsed on several threads;
+    // anything else is read a record at a time
+    if (!restore_records_in_parallel(restoring_file, num_rec, new_dc.lib_title)) {
+      new_dc.lib_title.reserve(size_t(min<streamoff>(max(num_rec, 0), max_num_saved)));
+      for (int i = 0; i < num_rec ; i++) {
+        Record* rec_ptr = new Record(restoring_file);
+        // records are saved in title order, so each one normally goes at the end
+        try {
+          new_dc.lib_title.insert(lib_title_lower_bound(new_dc, rec_ptr), rec_ptr);
+        } catch (...) {
+          delete rec_ptr;
+          throw;
+        }
+      }
     }
+    // the same records in ID order, sorted all at once
+    new_dc.lib_id = new_dc.lib_title;
+    sort(new_dc.lib_id.begin(), new_dc.lib_id.end(), [](const Record* lhs, const Record* rhs) {
+      return lhs->get_ID() < rhs->get_ID();
+    });
     int num_col = 0;
     if (!(restoring_file >> num_col)) {
       throw_file_exception();
     }
+    new_dc.cat.reserve(size_t(min<streamoff>(max(num_col, 0), max_num_saved)));
     for (int i = 0; i < num_col; i++) {
       insert_collection(new_dc, Collection(restoring_file, new_dc.lib_title));
     }
-    // clear dc passed in
-    dc.cat.clear();
-    clear_libraries(dc);
-    // safe to assign back to dc
-    dc = new_dc;
-    cout << "Data loaded\n";
-    restoring_file.close();
+    // index all the titles at once, in ID order, which is much faster than
+    // indexing them one at a time as they are read in title order
+    new_dc.title_index.rebuild(new_dc.lib_id);
+    new_dc.rating_index.rebuild(new_dc.lib_title);
+    new_dc.columns.rebuild(new_dc.lib_id);
   }
   catch (Error& err) {
-    // something went wrong with new_dc
-    new_dc.cat.clear();
-    clear_libraries(new_dc);
-    Record::restore_ID_counter();
+    // something went wrong with new_dc; dc and the ID counter are left as they were
+    discard_staged_data(new_dc);
     throw_file_exception();
   }
+  catch (...) {
+    discard_staged_data(new_dc);
+    throw;
+  }
+  // commit by exchanging the contents, which can't fail, and then discard the old
+  // data now in new_dc, collections first since they refer to the records
+  dc.swap(new_dc);
+  new_dc.cat.clear();
+  clear_libraries(new_dc);
+  cout << "Data loaded\n";
 }
 
-class String_finder {
-public:
-  // constructor
-  String_finder(string key_) : key(to_lower_case(key_)) {}
-  // note we have vector<Record*> in our libraries
-  void operator()(Record* rec_ptr) {
-    string title(to_lower_case(rec_ptr->get_title()));
-    // match is found
-    if (title.find(key) != string::npos) {
-      matching_rec_ptrs.push_back(rec_ptr);
-    }
-    
-  }
-  vector<Record*> get_matches() {
-    return matching_rec_ptrs;
-  }
-private:
-  vector<Record*> matching_rec_ptrs;
-  string key;
-  // converts a string to its corresponding lower_case
-  static string to_lower_case(const string& original) {
-    string new_string;
-    // allocate space
-    new_string.resize(original.size());
-    transform(original.begin(), original.end(), new_string.begin(), ::tolower);
-    return new_string;
-  }
-};
+static void discard_staged_data(Data_container& new_dc) {
+  new_dc.cat.clear();
+  clear_libraries(new_dc);
+  Record::restore_ID_counter();
+}
 
 static void find_with_string(const Data_container& dc) {
   string key;
   cin >> key;
-  String_finder helper(key);
-  helper = for_each(dc.lib_title.begin(), dc.lib_title.end(), helper);
-  auto matching_rec_ptrs = helper.get_matches();
+  auto matching_rec_ptrs = dc.title_index.find(key, dc.lib_title, dc.lib_id);
   if (matching_rec_ptrs.empty()) {
     throw Error("No records contain that string!");
   }
@@ -393,21 +519,40 @@ static void find_with_string(const Data_container& dc) {
 }
 
 static void list_ratings(const Data_container& dc) {
+  // "lr k" lists only the first k records, and "lr k offset" the k records
+  // starting at that position, for paging through a large library
+  int count = dc.rating_index.size();
+  int offset = 0;
+  if (read_optional_integer(count)) {
+    if (count <= 0) {
+      throw Error("Number of records must be positive!");
+    }
+    if (read_optional_integer(offset) && offset < 0) {
+      throw Error("Offset cannot be negative!");
+    }
+  }
   if (dc.lib_title.empty()) {
     cout << "Library is empty" << endl;
     return;
   }
-  Record_ptr_container_t sorted_by_rating = dc.lib_title;
-  // sort by rating first, then title
-  sort(sorted_by_rating.begin(), sorted_by_rating.end(), [](const Record* lhs, const Record* rhs) {
-    // if ratings are equal, look at title to decide
-    // if ratings are not equal, sort by highest rating to the left
-    return lhs->get_rating() == rhs->get_rating() ? *lhs < *rhs : lhs->get_rating() > rhs->get_rating();
-  });
-  ostream_iterator<Record*> out_it(cout, "\n");
-  copy(sorted_by_rating.begin(), sorted_by_rating.end(), out_it);
+  // the index is already sorted by rating first, then title
+  ostream_iterator<const Record*> out_it(cout, "\n");
+  dc.rating_index.apply(offset, count, [&out_it](const Record* rec_ptr) {*out_it++ = rec_ptr;});
+}
+
+static void collection_statistics(const Data_container& dc) {
+  // the statistics are kept up to date by Collection as members come and go
+  int lib_size = (int)dc.lib_title.size();
+  cout << Collection::get_num_records_in_any() << " out of " << lib_size << " Records appear in at least one Collection" << endl;
+  cout << Collection::get_num_records_in_many() << " out of " << lib_size << " Records appear in more than one Collection" << endl;
+  cout << "Collections contain a total of " << Collection::get_num_memberships() << " Records" << endl;
 }
 
+#ifdef P3_CHECK_STATISTICS
+// Recomputes the collection statistics the slow way, from the members of every
+// collection, and stops the program if they differ from the ones Collection keeps.
+// It runs after every command in a build with -DP3_CHECK_STATISTICS, such as the one
+// "make check" in the benchmarks directory runs the golden inputs with.
 class Collection_statistican {
 public:
   // constructor
@@ -416,12 +561,9 @@ public:
   
   void operator()(const Collection& col) {
     // the one range for
-    for (auto rec_ptr: col.get_list_of_record_ptrs()) {
-      // add key-value pair if it did not exist yet
-      if (map_of_id_to_num_col.find(rec_ptr->get_ID()) == map_of_id_to_num_col.end()) {
-        map_of_id_to_num_col[rec_ptr->get_ID()] = 0;
-      }
-      // now check current value, which is num of col for a particular id while iterating
+    for (auto rec_ptr: col.get_members()) {
+      // the count for a record seen for the first time starts at 0; this is the
+      // num of col for a particular id so far
       int& current_count = map_of_id_to_num_col[rec_ptr->get_ID()];
       if (!current_count) {
         // if current_count is 0, it must be in at least 1 collection
@@ -436,6 +578,11 @@ public:
     }
   }
   
+  // a record in no collection has no entry
+  int get_num_collections(int id) const {
+    auto it = map_of_id_to_num_col.find(id);
+    return it == map_of_id_to_num_col.end() ? 0 : it->second;
+  }
   int get_one() {
     return num_rec_in_at_least_one_col;
   }
@@ -453,14 +600,24 @@ private:
   int num_rec_in_all_col;
 };
 
-static void collection_statistics(const Data_container& dc) {
+static void check_collection_statistics(const Data_container& dc) {
   Collection_statistican helper;
-  helper = for_each(dc.cat.begin(), dc.cat.end(), helper);
-  int lib_size = (int)dc.lib_title.size();
-  cout << helper.get_one() << " out of " << lib_size << " Records appear in at least one Collection" << endl;
-  cout << helper.get_many() << " out of " << lib_size << " Records appear in more than one Collection" << endl;
-  cout << "Collections contain a total of " << helper.get_all() << " Records" << endl;
+  for (const Collection& col : dc.cat) {
+    helper(col);
+  }
+  bool consistent = helper.get_one() == Collection::get_num_records_in_any() &&
+  helper.get_many() == Collection::get_num_records_in_many() &&
+  helper.get_all() == Collection::get_num_memberships();
+  for (const Record* rec_ptr : dc.lib_title) {
+    consistent = consistent &&
+    helper.get_num_collections(rec_ptr->get_ID()) == rec_ptr->get_num_collections();
+  }
+  if (!consistent) {
+    cerr << "Collection statistics are inconsistent!" << endl;
+    abort();
+  }
 }
+#endif
 
 static void combine_collections(Data_container& dc) {
   Collection& first_col = *get_col_it_by_name(dc);
@@ -469,9 +626,8 @@ static void combine_collections(Data_container& dc) {
   string second_name = second_col.get_name();
   string new_name;
   cin >> new_name;
-  Collection new_col(new_name, first_col);
-  // concatenate
-  new_col += second_col;
+  // merged in a single pass into exactly the space needed
+  Collection new_col(new_name, first_col, second_col);
   insert_collection(dc, move(new_col));
   cout << "Collections " << first_name << " and " <<
   second_name << " combined into new collection " << new_name << endl;
@@ -492,18 +648,161 @@ static void modify_title(Data_container& dc) {
       list_col_ptrs.push_back(&col);
     }
   });
-  // remove record from the libraries
+  // remove record from the libraries, and from the indexes under its old title
+  dc.title_index.remove(rec_ptr);
+  dc.rating_index.remove(rec_ptr);
+  dc.columns.remove(rec_ptr);
   dc.lib_id.erase(it);
   dc.lib_title.erase(lib_title_lower_bound(dc, rec_ptr));
   // change record's title and insert it back
   string last_title = rec_ptr->get_title();
   rec_ptr->set_title(title);
   insert_record(dc, rec_ptr);
+  index_record(dc, rec_ptr);
   // add record back to all the collections it was originally in, using list
   for_each(list_col_ptrs.begin(), list_col_ptrs.end(), [rec_ptr](Collection* col_ptr) {col_ptr->add_member(rec_ptr);});
   cout << "Title for record " << rec_ptr->get_ID() << " changed to " << title << endl;
 }
 
+/* Adds the records in a file, which has the number of records followed by a line
+ for each one, as in the records part of a save file. The records get new IDs, as
+ they would from ar, in the order of the file; the saved ID numbers are skipped.
+ Nothing is added unless all of the records are valid and none has a title already
+ in the library or another record in the file. Instead of inserting the records one
+ by one, they are sorted once and merged into each library in a single pass. */
+static void import_records(Data_container& dc) {
+  string file_name;
+  cin >> file_name;
+  ifstream importing_file(file_name.c_str());
+  if (!importing_file) {
+    throw Error("Could not open file!");
+  }
+  int num_rec = 0;
+  if (!(importing_file >> num_rec) || num_rec < 0) {
+    throw_file_exception();
+  }
+  // the new records, in ID order, which is the order of the file
+  Record_ptr_container_t new_by_id;
+  Record::save_ID_counter();
+  auto discard_new_records = [&new_by_id]() {
+    Record::delete_all(new_by_id);
+    Record::restore_ID_counter();
+  };
+  try {
+    for (int i = 0; i < num_rec; i++) {
+      int saved_id, rating;
+      string medium;
+      if (!(importing_file >> saved_id >> medium >> rating) || rating < 0) {
+        throw_file_exception();
+      }
+      string title = read_and_compact_title(importing_file);
+      if (title.empty()) {
+        throw_file_exception();
+      }
+      // make room first, so that the new record can't be lost
+      new_by_id.push_back(nullptr);
+      new_by_id.back() = new Record(medium, title);
+      // zero is unrated, and set_rating rejects the rest of the out of range values
+      if (rating) {
+        new_by_id.back()->set_rating(rating);
+      }
+    }
+  }
+  catch (Error& err) {
+    discard_new_records();
+    throw_file_exception();
+  }
+  catch (...) {
+    discard_new_records();
+    throw;
+  }
+  Record_ptr_container_t merged_title, merged_id;
+  Rating_index merged_rating_index;
+  size_t num_indexed = 0;
+  try {
+    Record_ptr_container_t new_by_title(new_by_id);
+    sort(new_by_title.begin(), new_by_title.end(), Title_less_ptr());
+    // one pass over both sorted ranges; a title in the library and the file, or in
+    // the file twice, then ends up next to itself
+    merged_title.reserve(dc.lib_title.size() + new_by_title.size());
+    merge(dc.lib_title.begin(), dc.lib_title.end(), new_by_title.begin(), new_by_title.end(),
+          back_inserter(merged_title), Title_less_ptr());
+    if (adjacent_find(merged_title.begin(), merged_title.end(), [](Record* lhs, Record* rhs) {
+      return !(*lhs < *rhs);}) != merged_title.end()) {
+      throw Error_no_clear("Library already has a record with this title!");
+    }
+    // the new records have the highest IDs, so the merge by ID is an append
+    merged_id.reserve(dc.lib_id.size() + new_by_id.size());
+    merged_id = dc.lib_id;
+    merged_id.insert(merged_id.end(), new_by_id.begin(), new_by_id.end());
+    merged_rating_index.rebuild(merged_title);
+    // new IDs go at the ends of the posting lists and the columns, so this is
+    // fast as well
+    for (; num_indexed < new_by_id.size(); num_indexed++) {
+      dc.title_index.insert(new_by_id[num_indexed]);
+      dc.columns.insert(new_by_id[num_indexed]);
+    }
+  }
+  catch (...) {
+    // the one being indexed when it failed may be partly in the index
+    for (size_t i = 0; i <= num_indexed && i < new_by_id.size(); i++) {
+      dc.title_index.remove(new_by_id[i]);
+      dc.columns.remove(new_by_id[i]);
+    }
+    discard_new_records();
+    throw;
+  }
+  // nothing below can fail
+  dc.lib_title.swap(merged_title);
+  dc.lib_id.swap(merged_id);
+  dc.rating_index.swap(merged_rating_index);
+  cout << new_by_id.size() << " records imported" << endl;
+}
+
+/* Answers a query over the library, given on the rest of the line as the kind of
+ answer wanted, then any number of conditions joined by "and", as in
+ "qr count rating >= 4 and medium = DVD". The answer is the number of records
+ meeting all of the conditions ("count"), that and how many of them have each
+ rating ("histogram"), or that and the records themselves in ID order ("list").
+ A condition compares id, rating or medium to a value with =, !=, <, <=, > or >=;
+ a medium can only be compared with = or !=, and "u" is the rating of an unrated
+ record. The conditions are evaluated with scans over the columns rather than by
+ looking at each record. */
+static void query_records(const Data_container& dc) {
+  string line;
+  getline(cin, line);
+  istringstream query(line);
+  string answer;
+  query >> answer;
+  if (answer != "count" && answer != "histogram" && answer != "list") {
+    throw Error_no_clear("Unrecognized query!");
+  }
+  Record_columns::Selection_t selection = dc.columns.select_all();
+  string conjunction;
+  // with no conditions, every record matches
+  query >> ws;
+  if (!query.eof()) {
+    restrict_query(dc, query, selection);
+    while (query >> conjunction) {
+      if (conjunction != "and") {
+        throw Error_no_clear("Invalid query condition!");
+      }
+      restrict_query(dc, query, selection);
+    }
+  }
+  cout << dc.columns.count(selection) << " records match" << (answer == "list" ? ":" : "") << endl;
+  if (answer == "histogram") {
+    vector<int> counts = dc.columns.count_by_rating(selection);
+    for (int rating = 1; rating < int(counts.size()); rating++) {
+      cout << "Rating " << rating << ": " << counts[rating] << endl;
+    }
+    cout << "Unrated: " << counts[0] << endl;
+  }
+  else if (answer == "list") {
+    dc.columns.print(cout, selection);
+  }
+}
+
 static Record_ptr_container_t::iterator get_rec_it_by_title(Data_container& dc) {
   string title = read_and_compact_title(cin);
   check_empty_title(title);
@@ -574,6 +873,24 @@ static const Record* insert_record(Data_container& dc, Record* rec_ptr) {
   return rec_ptr;
 }
 
+static void index_record(Data_container& dc, const Record* rec_ptr) {
+  // if indexing fails, the record may be in some of the indexes, so it is removed
+  // from them and then from the libraries, as insert_record would do
+  try {
+    dc.title_index.insert(rec_ptr);
+    dc.rating_index.insert(rec_ptr);
+    dc.columns.insert(rec_ptr);
+  } catch (...) {
+    dc.title_index.remove(rec_ptr);
+    dc.rating_index.remove(rec_ptr);
+    dc.columns.remove(rec_ptr);
+    dc.lib_title.erase(lib_title_lower_bound(dc, rec_ptr));
+    dc.lib_id.erase(lib_id_lower_bound(dc, rec_ptr));
+    delete rec_ptr;
+    throw;
+  }
+}
+
 static void insert_collection(Data_container& dc, const Collection&& col) {
   auto it = cat_lower_bound(dc, col);
   if ((it != dc.cat.end()) && (*it == col)) {
@@ -584,10 +901,13 @@ static void insert_collection(Data_container& dc, const Collection&& col) {
 
 
 static void clear_libraries(Data_container& dc) {
-  // clear dynamic records first
-  for_each(dc.lib_title.begin(), dc.lib_title.end(), [](Record* rec_ptr) {delete rec_ptr;});
+  // clear dynamic records first, handing their slabs back all at once
+  Record::delete_all(dc.lib_title);
   dc.lib_title.clear();
   dc.lib_id.clear();
+  dc.title_index.clear();
+  dc.rating_index.clear();
+  dc.columns.clear();
 }
 
 // custom functor to help me compact title correctly
@@ -665,6 +985,52 @@ static Collection_container_t::iterator cat_lower_bound(Data_container& dc,
   return lower_bound(dc.cat.begin(), dc.cat.end(), col);
 }
 
+static void restrict_query(const Data_container& dc, istream& query,
+                           Record_columns::Selection_t& selection) {
+  static const map<string, Record_columns::Field_e> fields = {
+    {"id", Record_columns::ID_FIELD},
+    {"rating", Record_columns::RATING_FIELD},
+    {"medium", Record_columns::MEDIUM_FIELD}
+  };
+  static const map<string, Record_columns::Comparison_e> comparisons = {
+    {"=", Record_columns::EQUAL},
+    {"!=", Record_columns::NOT_EQUAL},
+    {"<", Record_columns::LESS},
+    {"<=", Record_columns::LESS_EQUAL},
+    {">", Record_columns::GREATER},
+    {">=", Record_columns::GREATER_EQUAL}
+  };
+  string field_name, comparison_name, value_string;
+  if (!(query >> field_name >> comparison_name >> value_string)) {
+    throw Error_no_clear("Invalid query condition!");
+  }
+  auto field_it = fields.find(field_name);
+  auto comparison_it = comparisons.find(comparison_name);
+  if (field_it == fields.end() || comparison_it == comparisons.end()) {
+    throw Error_no_clear("Invalid query condition!");
+  }
+  Record_columns::Field_e field = field_it->second;
+  Record_columns::Comparison_e comparison = comparison_it->second;
+  int value = 0;
+  if (field == Record_columns::MEDIUM_FIELD) {
+    if (comparison != Record_columns::EQUAL && comparison != Record_columns::NOT_EQUAL) {
+      throw Error_no_clear("Invalid query condition!");
+    }
+    // a medium no record has matches nothing, which the code -1 does
+    value = dc.columns.get_medium_code(value_string);
+  }
+  else if (field == Record_columns::RATING_FIELD && value_string == "u") {
+    value = 0;
+  }
+  else {
+    istringstream value_stream(value_string);
+    if (!(value_stream >> value) || !(value_stream >> ws).eof()) {
+      throw Error_no_clear("Invalid query condition!");
+    }
+  }
+  dc.columns.restrict(selection, field, comparison, value);
+}
+
 static int read_integer() {
   int id;
   if (!(cin >> id)) {
@@ -672,3 +1038,16 @@ static int read_integer() {
   }
   return id;
 }
+
+// reads an integer if one follows on the same line, and returns whether it did
+static bool read_optional_integer(int& value) {
+  while (cin.peek() == ' ' || cin.peek() == '\t') {
+    cin.get();
+  }
+  int next = cin.peek();
+  if (!isdigit(next) && next != '-' && next != '+') {
+    return false;
+  }
+  value = read_integer();
+  return true;
+}
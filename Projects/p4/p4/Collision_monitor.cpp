@@ -0,0 +1,204 @@
+#include "Collision_monitor.h"
+#include "Ship.h"
+#include "Geometry.h"
+#include "Navigation.h"
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <numeric>
+#include <cmath>
+#include <cassert>
+
+using namespace std;
+
+// the range and time horizon must not be negative
+Collision_monitor::Collision_monitor(double warning_range_, double time_horizon_) :
+warning_range(warning_range_), time_horizon(time_horizon_), num_candidates(0)
+{
+  assert(warning_range >= 0. && time_horizon >= 0.);
+}
+
+// Use these limits from the next update on; they must not be negative.
+void Collision_monitor::set_limits(double warning_range_, double time_horizon_)
+{
+  assert(warning_range_ >= 0. && time_horizon_ >= 0.);
+  warning_range = warning_range_;
+  time_horizon = time_horizon_;
+}
+
+// Replace the warnings with those for the supplied ships, as they are now.
+void Collision_monitor::update(const vector<const Ship*>& ships)
+{
+  gather_tracks(ships);
+  find_candidates();
+  compute_CPAs();
+  warnings.clear();
+  for (size_t i = 0; i < first_tracks.size(); i++)
+  {
+    if (times_to_CPA[i] > time_horizon || CPA_ranges[i] > warning_range)
+    {
+      continue;
+    }
+    const string& first_name = tracks[first_tracks[i]]->get_name();
+    const string& second_name = tracks[second_tracks[i]]->get_name();
+    if (first_name < second_name)
+    {
+      warnings.push_back(Warning{first_name, second_name, CPA_ranges[i], times_to_CPA[i]});
+    }
+    else
+    {
+      warnings.push_back(Warning{second_name, first_name, CPA_ranges[i], times_to_CPA[i]});
+    }
+  }
+  sort(warnings.begin(), warnings.end(), [](const Warning& lhs, const Warning& rhs)
+       {
+         return lhs.first_name < rhs.first_name ||
+         (lhs.first_name == rhs.first_name && lhs.second_name < rhs.second_name);
+       });
+}
+
+/* Private Function Definitions */
+
+// record the tracks of the ships to be monitored
+void Collision_monitor::gather_tracks(const vector<const Ship*>& ships)
+{
+  tracks.clear();
+  x.clear();
+  y.clear();
+  velocity_x.clear();
+  velocity_y.clear();
+  for (const Ship *ship : ships)
+  {
+    if (!ship->is_afloat() || ship->is_docked())
+    {
+      continue;
+    }
+    Point position = ship->get_location();
+    Cartesian_vector velocity = to_unit_Cartesian_vector(ship->get_course()) * ship->get_speed();
+    tracks.push_back(ship);
+    x.push_back(position.x);
+    y.push_back(position.y);
+    velocity_x.push_back(velocity.delta_x);
+    velocity_y.push_back(velocity.delta_y);
+  }
+}
+
+// Find the pairs of tracks whose boxes overlap. A single sweep across the whole area would
+// keep every box spanning the sweep's position open, top to bottom, so the area is cut into
+// horizontal bands about twice as high as the average box, each box is put in every band it
+// reaches, and each band is swept on its own. A pair whose boxes share several bands is only
+// taken from the lowest of them, the one holding the higher of their bottom edges.
+void Collision_monitor::find_candidates()
+{
+  first_tracks.clear();
+  second_tracks.clear();
+  num_candidates = 0;
+  int num_tracks = int(tracks.size());
+  if (num_tracks < 2)
+  {
+    return;
+  }
+  double margin = warning_range / 2.;
+  vector<double> left(num_tracks), right(num_tracks), bottom(num_tracks), top(num_tracks);
+  double lowest = 0., highest = 0., total_height = 0.;
+  for (int i = 0; i < num_tracks; i++)
+  {
+    double end_x = x[i] + velocity_x[i] * time_horizon;
+    double end_y = y[i] + velocity_y[i] * time_horizon;
+    left[i] = min(x[i], end_x) - margin;
+    right[i] = max(x[i], end_x) + margin;
+    bottom[i] = min(y[i], end_y) - margin;
+    top[i] = max(y[i], end_y) + margin;
+    lowest = i == 0 ? bottom[i] : min(lowest, bottom[i]);
+    highest = i == 0 ? top[i] : max(highest, top[i]);
+    total_height += top[i] - bottom[i];
+  }
+  // no more bands than tracks, and one if all of the boxes are flat
+  double band_height = max(2. * total_height / num_tracks, (highest - lowest) / num_tracks);
+  int num_bands = band_height > 0. ? min(num_tracks, int((highest - lowest) / band_height) + 1) : 1;
+  auto band_of = [lowest, band_height, num_bands](double y_coordinate)
+  {
+    return band_height > 0. ? min(num_bands - 1, int((y_coordinate - lowest) / band_height)) : 0;
+  };
+
+  vector<int> order(num_tracks);
+  iota(order.begin(), order.end(), 0);
+  sort(order.begin(), order.end(), [&left](int lhs, int rhs)
+       {
+         return left[lhs] < left[rhs] || (left[lhs] == left[rhs] && lhs < rhs);
+       });
+  // the tracks in each band, in the order of their left edges
+  vector<vector<int>> bands(num_bands);
+  for (int track : order)
+  {
+    for (int band = band_of(bottom[track]); band <= band_of(top[track]); band++)
+    {
+      bands[band].push_back(track);
+    }
+  }
+  vector<int> open;
+  for (int band = 0; band < num_bands; band++)
+  {
+    open.clear();
+    for (int track : bands[band])
+    {
+      // close the boxes that end before this one starts
+      open.erase(remove_if(open.begin(), open.end(), [&right, &left, track](int other)
+                           {
+                             return right[other] < left[track];
+                           }), open.end());
+      for (int other : open)
+      {
+        if (bottom[other] <= top[track] && bottom[track] <= top[other] &&
+            band_of(max(bottom[other], bottom[track])) == band)
+        {
+          first_tracks.push_back(other);
+          second_tracks.push_back(track);
+        }
+      }
+      open.push_back(track);
+    }
+  }
+  num_candidates = (long long)first_tracks.size();
+}
+
+// Compute the CPA of every candidate pair. The relative positions and velocities are
+// gathered first, so that the computation itself only reads and writes consecutive
+// elements and has no branches.
+void Collision_monitor::compute_CPAs()
+{
+  size_t num_pairs = first_tracks.size();
+  relative_x.resize(num_pairs);
+  relative_y.resize(num_pairs);
+  relative_velocity_x.resize(num_pairs);
+  relative_velocity_y.resize(num_pairs);
+  CPA_ranges.resize(num_pairs);
+  times_to_CPA.resize(num_pairs);
+  for (size_t i = 0; i < num_pairs; i++)
+  {
+    int first = first_tracks[i];
+    int second = second_tracks[i];
+    relative_x[i] = x[second] - x[first];
+    relative_y[i] = y[second] - y[first];
+    relative_velocity_x[i] = velocity_x[second] - velocity_x[first];
+    relative_velocity_y[i] = velocity_y[second] - velocity_y[first];
+  }
+  const double* dxs = relative_x.data();
+  const double* dys = relative_y.data();
+  const double* dvxs = relative_velocity_x.data();
+  const double* dvys = relative_velocity_y.data();
+  double* ranges = CPA_ranges.data();
+  double* times = times_to_CPA.data();
+  for (size_t i = 0; i < num_pairs; i++)
+  {
+    double closing = -(dxs[i] * dvxs[i] + dys[i] * dvys[i]);
+    double relative_speed_squared = dvxs[i] * dvxs[i] + dvys[i] * dvys[i];
+    // with no relative motion, or moving apart, the CPA is now
+    bool approaching = relative_speed_squared > 0. && closing > 0.;
+    double time = approaching ? closing / (approaching ? relative_speed_squared : 1.) : 0.;
+    double cpa_x = dxs[i] + dvxs[i] * time;
+    double cpa_y = dys[i] + dvys[i] * time;
+    ranges[i] = sqrt(cpa_x * cpa_x + cpa_y * cpa_y);
+    times[i] = time;
+  }
+}
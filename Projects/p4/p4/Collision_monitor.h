@@ -0,0 +1,98 @@
+#ifndef COLLISION_MONITOR_H
+#define COLLISION_MONITOR_H
+
+#include <string>
+#include <vector>
+
+class Ship;
+
+/***** Collision_monitor Class *****/
+/* A Collision_monitor finds the pairs of ships that will pass close to each other soon if
+ they hold their courses and speeds: those whose closest point of approach (CPA) is within the
+ warning range, and comes within the time horizon. Docked ships and ships that are not afloat
+ are ignored. The CPA is worked out as compute_CPA does, except that two ships on the same
+ course at the same speed are at their CPA now.
+
+ Rather than testing every pair, the monitor puts a box around the path each ship will
+ follow over the time horizon, grown by half the warning range on every side; two ships can
+ only come within the range of each other within the horizon if their boxes overlap. The
+ area is cut into horizontal bands, and the boxes in each band are sorted by their left edges
+ and swept from left to right, keeping a list of the boxes the sweep is still inside, so only
+ the pairs whose boxes overlap from left to right are looked at, and only those that also
+ overlap from bottom to top become candidates. The CPAs of the candidates are then computed
+ together, in a loop the compiler can vectorize.
+ */
+
+class Collision_monitor {
+public:
+  // a warning for a pair of ships, named in alphabetical order
+  struct Warning {
+    std::string first_name;
+    std::string second_name;
+    double CPA_range;
+    double time_to_CPA;
+  };
+
+  // the range and time horizon must not be negative
+  Collision_monitor(double warning_range_, double time_horizon_);
+
+  // Replace the warnings with those for the supplied ships, as they are now.
+  void update(const std::vector<const Ship*>& ships);
+
+  // the warnings found by the last update, in order of the ships' names
+  const std::vector<Warning>& get_warnings() const
+  {
+    return warnings;
+  }
+
+  // the number of pairs whose CPA was computed by the last update
+  long long get_num_candidates() const
+  {
+    return num_candidates;
+  }
+
+  double get_warning_range() const
+  {
+    return warning_range;
+  }
+
+  double get_time_horizon() const
+  {
+    return time_horizon;
+  }
+
+  // Use these limits from the next update on; they must not be negative.
+  void set_limits(double warning_range_, double time_horizon_);
+
+private:
+  double warning_range;
+  double time_horizon;
+  std::vector<Warning> warnings;
+  long long num_candidates;
+
+  // the ships being monitored, and their positions and velocities, by track index
+  std::vector<const Ship*> tracks;
+  std::vector<double> x;
+  std::vector<double> y;
+  std::vector<double> velocity_x;
+  std::vector<double> velocity_y;
+
+  // the candidate pairs, by track index, and their relative positions and velocities
+  std::vector<int> first_tracks;
+  std::vector<int> second_tracks;
+  std::vector<double> relative_x;
+  std::vector<double> relative_y;
+  std::vector<double> relative_velocity_x;
+  std::vector<double> relative_velocity_y;
+  std::vector<double> CPA_ranges;
+  std::vector<double> times_to_CPA;
+
+  // record the tracks of the ships to be monitored
+  void gather_tracks(const std::vector<const Ship*>& ships);
+  // find the pairs of tracks whose boxes overlap
+  void find_candidates();
+  // compute the CPA of every candidate pair
+  void compute_CPAs();
+};
+
+#endif
@@ -14,10 +14,15 @@
 #include "Geometry.h"
 #include "Ship_factory.h"
 #include "Utility.h"
+#include "Logger.h"
 #include <string>
 #include <iostream>
 #include <map>
 #include <limits>
+#include <cctype>
+#include <sstream>
+#include <algorithm>
+#include <vector>
 
 using namespace std;
 
@@ -27,12 +32,12 @@ const int MAX_COURSE_DEGREES = 360;
 // output constructor message
 Controller::Controller()
 {
-  cout << "Controller constructed" << endl;
+  Log_line(LOG_LIFECYCLE, LOG_DETAILS) << "Controller constructed";
 }
 // output destructor message
 Controller::~Controller()
 {
-  cout << "Controller destructed" << endl;
+  Log_line(LOG_LIFECYCLE, LOG_DETAILS) << "Controller destructed";
 }
 
 // create View object, run the program by accepting user commands, then destroy View object
@@ -44,6 +49,8 @@ void Controller::run()
   {
     try
     {
+      // what the last command logged has to come before the prompt
+      g_Logger.flush();
       cout << "\nTime " << g_Model_ptr->get_time() << ": Enter command: ";
       string command;
       cin >> command;
@@ -78,12 +85,14 @@ void Controller::run()
     }
     catch (Error& e)
     {
+      g_Logger.flush();
       cout << e.what() << endl;
       cin.clear();
       cin.ignore(numeric_limits<streamsize>::max(), '\n');
     }
     catch (...)
     {
+      g_Logger.flush();
       cout << "An unknown error occurred!" << endl;
       return;
     }
@@ -127,6 +136,7 @@ bool Controller::quit(View *view)
 {
   g_Model_ptr->detach(view);
   delete view;
+  g_Logger.flush();
   cout << "Done" << endl;
   return true;
 }
@@ -167,9 +177,18 @@ bool Controller::model_status(View *view)
   g_Model_ptr->describe();
   return false;
 }
+// "go" alone updates once; "go <hours>" advances that many hours at once
 bool Controller::model_go(View *view)
 {
-  g_Model_ptr->update();
+  while (cin.peek() == ' ' || cin.peek() == '\t') cin.get();
+  if (!isdigit(cin.peek()) && cin.peek() != '-' && cin.peek() != '+')
+  {
+    g_Model_ptr->update();
+    return false;
+  }
+  int hours = read_int();
+  if (hours < 1) throw Error("Number of hours must be at least 1!");
+  g_Model_ptr->advance(hours);
   return false;
 }
 bool Controller::model_create(View *view)
@@ -186,6 +205,102 @@ bool Controller::model_create(View *view)
   g_Model_ptr->add_ship(create_ship(new_name, new_type, Point(point_x, point_y)));
   return false;
 }
+// compute the ships' steps on this many threads; with fewer than about 2000 ships they
+// are still computed on one thread, since waking the others would cost more than it saves
+bool Controller::model_threads(View *view)
+{
+  int num_threads = read_int();
+  if (num_threads < 1) throw Error("Number of threads must be at least 1!");
+  g_Model_ptr->set_num_threads(num_threads);
+  return false;
+}
+// list the objects within a radius of a point, or of a ship or island, other than itself
+bool Controller::model_near(View *view)
+{
+  string first_word;
+  cin >> first_word;
+  istringstream first_stream(first_word);
+  double point_x;
+  Sim_object *center_object = nullptr;
+  Point center;
+  if (first_stream >> point_x && first_stream.eof())
+  {
+    center = Point(point_x, read_double());
+  }
+  else
+  {
+    if (g_Model_ptr->is_ship_present(first_word)) center_object = g_Model_ptr->get_ship_ptr(first_word);
+    else if (g_Model_ptr->is_island_present(first_word)) center_object = g_Model_ptr->get_island_ptr(first_word);
+    else throw Error("Object not found!");
+    center = center_object->get_location();
+  }
+  double radius = read_double();
+  if (radius < 0) throw Error("Negative radius entered!");
+  vector<Sim_object*> found = g_Model_ptr->objects_within(center, radius);
+  found.erase(remove(found.begin(), found.end(), center_object), found.end());
+  if (found.empty()) cout << "No objects";
+  else cout << "Objects";
+  cout << " within " << radius << " nm of ";
+  if (center_object) cout << center_object->get_name();
+  else cout << center;
+  cout << (found.empty() ? "" : ":") << endl;
+  for (Sim_object *object : found)
+  {
+    cout << object->get_name() << " at " << object->get_location() << ", range "
+    << cartesian_distance(center, object->get_location()) << " nm" << endl;
+  }
+  return false;
+}
+// list the collision warnings found by the last update
+bool Controller::model_warnings(View *view)
+{
+  const vector<Collision_monitor::Warning>& warnings = g_Model_ptr->get_collision_warnings();
+  if (warnings.empty()) cout << "No collision warnings";
+  else cout << "Collision warnings";
+  cout << " for CPA within " << g_Model_ptr->get_warning_range() << " nm and "
+  << g_Model_ptr->get_time_horizon() << " hr" << (warnings.empty() ? "" : ":") << endl;
+  for (const Collision_monitor::Warning& warning : warnings)
+  {
+    cout << warning.first_name << " and " << warning.second_name << ": CPA " << warning.CPA_range
+    << " nm in " << warning.time_to_CPA << " hr" << endl;
+  }
+  return false;
+}
+// set the range and time horizon for collision warnings
+bool Controller::model_warning_limits(View *view)
+{
+  double warning_range = read_double();
+  if (warning_range < 0) throw Error("Negative range entered!");
+  double time_horizon = read_double();
+  if (time_horizon < 0) throw Error("Negative time entered!");
+  g_Model_ptr->set_warning_limits(warning_range, time_horizon);
+  return false;
+}
+
+// log functions
+// set the level of logging, or turn a category of logging on or off
+bool Controller::log_settings(View *view)
+{
+  static const map<string, Log_level_e> levels {
+    {"quiet", LOG_QUIET}, {"events", LOG_EVENTS}, {"details", LOG_DETAILS}
+  };
+  static const map<string, Log_category_e> categories {
+    {"lifecycle", LOG_LIFECYCLE}, {"movement", LOG_MOVEMENT}, {"cargo", LOG_CARGO}, {"combat", LOG_COMBAT}
+  };
+  string setting;
+  cin >> setting;
+  if (levels.find(setting) != levels.end())
+  {
+    g_Logger.set_level(levels.at(setting));
+    return false;
+  }
+  if (categories.find(setting) == categories.end()) throw Error("Unrecognized log level or category!");
+  string on_off;
+  cin >> on_off;
+  if (on_off != "on" && on_off != "off") throw Error("Expected on or off!");
+  g_Logger.set_category_enabled(categories.at(setting), on_off == "on");
+  return false;
+}
 
 // ship functions
 void Controller::ship_course(Ship *ship)
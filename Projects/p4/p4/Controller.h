@@ -47,6 +47,13 @@ private:
   bool model_status(View *view);
   bool model_go(View *view);
   bool model_create(View *view);
+  bool model_threads(View *view);
+  bool model_near(View *view);
+  bool model_warnings(View *view);
+  bool model_warning_limits(View *view);
+  
+  // log functions
+  bool log_settings(View *view);
   
   // ship functions
   typedef void (Controller::*ship_func)(Ship *);
@@ -72,7 +79,13 @@ private:
     
     {"status", &Controller::model_status},
     {"go", &Controller::model_go},
-    {"create", &Controller::model_create}
+    {"create", &Controller::model_create},
+    {"threads", &Controller::model_threads},
+    {"near", &Controller::model_near},
+    {"warnings", &Controller::model_warnings},
+    {"warning_limits", &Controller::model_warning_limits},
+    
+    {"log", &Controller::log_settings}
   };
   
   std::map<std::string, ship_func> ship_func_map {
@@ -9,6 +9,7 @@
 #include "Warship.h"
 #include "Ship.h"
 #include "Geometry.h"
+#include "Logger.h"
 #include <string>
 #include <iostream>
 
@@ -26,13 +27,13 @@ Cruiser::Cruiser(const string &name_, Point position_) :
 Warship(name_, position_, CRUISER_INIT_FUEL, CRUISER_MAX_SPEED, CRUISER_FUEL_CONSUMPTION,
         CRUISER_INIT_RESISTANCE, CRUISER_FIREPOWER, CRUISER_MAX_RANGE)
 {
-  cout << "Cruiser " << get_name() << " constructed" << endl;
+  Log_line(LOG_LIFECYCLE, LOG_DETAILS) << "Cruiser " << get_name() << " constructed";
 }
 
 // output destructor message
 Cruiser::~Cruiser()
 {
-  cout << "Cruiser " << get_name() << " destructed" << endl;
+  Log_line(LOG_LIFECYCLE, LOG_DETAILS) << "Cruiser " << get_name() << " destructed";
 }
 
 void Cruiser::update()
@@ -45,7 +46,7 @@ void Cruiser::update()
   }
   else
   {
-    cout << get_name() << " target is out of range" << endl;
+    Log_line(LOG_COMBAT, LOG_EVENTS) << get_name() << " target is out of range";
     stop_attack();
   }
 }
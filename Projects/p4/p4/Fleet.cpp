@@ -0,0 +1,149 @@
+#include "Fleet.h"
+#include "Geometry.h"
+#include "Navigation.h"
+#include "Thread_pool.h"
+#include <vector>
+#include <cmath>
+#include <algorithm>
+
+using namespace std;
+
+// the fewest slots whose steps are worth handing to another thread, at a few nanoseconds
+// each against the microseconds it takes to wake a thread; fewer slots than twice this are
+// all done on the calling thread
+const int MIN_STEPS_PER_CHUNK = 1024;
+// the slots are split into about this many chunks for each thread, so that a thread that
+// finishes early has some to steal
+const int CHUNKS_PER_THREAD = 4;
+
+// Take a slot for a Ship with the supplied fuel consumption, which starts out not moving,
+// and return its index.
+int Fleet::add_slot(double fuel_consumption)
+{
+  int slot;
+  if (!free_slots.empty())
+  {
+    slot = free_slots.back();
+    free_slots.pop_back();
+  }
+  else
+  {
+    slot = int(motion.size());
+    x.push_back(0.);
+    y.push_back(0.);
+    unit_x.push_back(0.);
+    unit_y.push_back(0.);
+    speed.push_back(0.);
+    fuel.push_back(0.);
+    consumption.push_back(0.);
+    destination_x.push_back(0.);
+    destination_y.push_back(0.);
+    motion.push_back(NOT_MOVING);
+    step_x.push_back(0.);
+    step_y.push_back(0.);
+    step_fuel.push_back(0.);
+    step_outcome.push_back(KEEPS_MOVING);
+    step_ready.push_back(false);
+  }
+  consumption[slot] = fuel_consumption;
+  motion[slot] = NOT_MOVING;
+  step_ready[slot] = false;
+  return slot;
+}
+
+// Give back the slot; a slot that isn't moving is skipped by compute_steps.
+void Fleet::remove_slot(int slot)
+{
+  motion[slot] = NOT_MOVING;
+  step_ready[slot] = false;
+  free_slots.push_back(slot);
+}
+
+// Record the course, speed, and destination (if any) a Ship has been told to move on.
+void Fleet::set_course(int slot, Course_speed course_speed, Point destination)
+{
+  Cartesian_vector unit = to_unit_Cartesian_vector(course_speed.course);
+  unit_x[slot] = unit.delta_x;
+  unit_y[slot] = unit.delta_y;
+  speed[slot] = course_speed.speed;
+  destination_x[slot] = destination.x;
+  destination_y[slot] = destination.y;
+  step_ready[slot] = false;
+}
+
+// Record how a Ship is moving, where it is, and how much fuel it has.
+void Fleet::set_state(int slot, Motion_e motion_, Point position, double fuel_)
+{
+  motion[slot] = motion_;
+  x[slot] = position.x;
+  y[slot] = position.y;
+  fuel[slot] = fuel_;
+  step_ready[slot] = false;
+}
+
+// Compute the step for the next hour for every slot that is moving, sharing the slots
+// out among the threads of the pool if one is supplied and there are enough of them.
+// The chunks are sized for the pool, so that a fleet as big as the Model allows is split.
+void Fleet::compute_steps(Thread_pool *pool_ptr)
+{
+  int num_slots = int(motion.size());
+  if (!pool_ptr || pool_ptr->get_num_threads() == 1 || num_slots < 2 * MIN_STEPS_PER_CHUNK)
+  {
+    compute_steps_in(0, num_slots);
+    return;
+  }
+  int num_chunks = pool_ptr->get_num_threads() * CHUNKS_PER_THREAD;
+  int grain = max(MIN_STEPS_PER_CHUNK, (num_slots + num_chunks - 1) / num_chunks);
+  pool_ptr->parallel_for(num_slots, grain,
+                         [this](int begin, int end){compute_steps_in(begin, end);});
+}
+
+/*
+ Compute the steps for the slots from begin up to end. This is
+ Ship::calculate_movement for one hour, done for all of the slots at once: both ways the
+ step could go are computed for every slot and the right one is picked without branching,
+ so the loop can be vectorized. Every value is computed with the same operations as there,
+ so the results are the same to the last bit. The results for a slot that isn't moving
+ are computed too, but it isn't marked as having a step.
+ */
+void Fleet::compute_steps_in(int begin, int end)
+{
+  const double* xs = x.data();
+  const double* ys = y.data();
+  const double* unit_xs = unit_x.data();
+  const double* unit_ys = unit_y.data();
+  const double* speeds = speed.data();
+  const double* fuels = fuel.data();
+  const double* consumptions = consumption.data();
+  const double* destination_xs = destination_x.data();
+  const double* destination_ys = destination_y.data();
+  const unsigned char* motions = motion.data();
+  double* step_xs = step_x.data();
+  double* step_ys = step_y.data();
+  double* step_fuels = step_fuel.data();
+  unsigned char* step_outcomes = step_outcome.data();
+  unsigned char* step_readies = step_ready.data();
+  for (int i = begin; i < end; i++)
+  {
+    // the distance to the destination, as cartesian_distance computes it
+    double xd = destination_xs[i] - xs[i];
+    double yd = destination_ys[i] - ys[i];
+    double destination_distance = sqrt(xd * xd + yd * yd);
+    // the full step is the speed for one hour
+    double full_distance = speeds[i];
+    double full_fuel_required = full_distance * consumptions[i];
+    bool full_step_possible = full_fuel_required <= fuels[i];
+    double distance_possible = full_step_possible ? full_distance : fuels[i] / consumptions[i];
+    double time_possible = full_step_possible ? 1. : (distance_possible / full_distance) * 1.;
+    bool arrives = motions[i] == MOVING_TO_POSITION && destination_distance <= distance_possible;
+    bool runs_out = full_fuel_required >= fuels[i];
+    // the Compass_vector for the time possible, as a Cartesian_vector
+    double distance_moved = speeds[i] * time_possible;
+    step_xs[i] = arrives ? destination_xs[i] : xs[i] + distance_moved * unit_xs[i];
+    step_ys[i] = arrives ? destination_ys[i] : ys[i] + distance_moved * unit_ys[i];
+    step_fuels[i] = arrives ? fuels[i] - destination_distance * consumptions[i] :
+                    (runs_out ? 0. : fuels[i] - full_fuel_required);
+    step_outcomes[i] = arrives ? ARRIVED : (runs_out ? OUT_OF_FUEL : KEEPS_MOVING);
+    step_readies[i] = motions[i] != NOT_MOVING;
+  }
+}
@@ -0,0 +1,96 @@
+#ifndef FLEET_H
+#define FLEET_H
+
+#include "Geometry.h"
+#include "Navigation.h"
+#include <vector>
+
+class Thread_pool;
+
+/***** Fleet Class *****/
+/* A Fleet keeps the state that governs how its Ships move - position, the unit vector of the
+ course, speed, fuel, fuel consumption, destination and whether and how the Ship is moving -
+ in parallel arrays, with a slot in each array for each Ship. Once per tick, compute_steps
+ works out where every moving Ship will be after the hour, and how much fuel and in what state
+ it will be left, in a single pass over the arrays, with the same arithmetic, in the same order,
+ as Ship::calculate_movement, so the results are identical. The steps are only proposals: each
+ Ship takes its own step when it is updated, so Ships still change one at a time in the order
+ the Model updates them, and what one Ship sees of another during a tick is unchanged.
+ A Ship records its state in its slot whenever it changes, which discards any step already
+ computed for the slot, so a Ship whose state changed after the pass moves as it always did.
+ The step of each slot depends on nothing but the slot's own state, so the steps can be
+ computed on several threads, in any order, and still come out exactly the same.
+ The Fleet knows nothing about Ships; it only holds numbers for them.
+ */
+
+class Fleet {
+public:
+  // how a slot is moving, as far as the Fleet is concerned
+  enum Motion_e : unsigned char {NOT_MOVING, MOVING_ON_COURSE, MOVING_TO_POSITION};
+  // what happens at the end of a computed step
+  enum Outcome_e : unsigned char {KEEPS_MOVING, ARRIVED, OUT_OF_FUEL};
+
+  // Take a slot for a Ship with the supplied fuel consumption, which starts out not moving,
+  // and return its index. A slot given back by remove_slot may be handed out again.
+  int add_slot(double fuel_consumption);
+  // Give back the slot.
+  void remove_slot(int slot);
+
+  // Record the course, speed, and destination (if any) a Ship has been told to move on.
+  void set_course(int slot, Course_speed course_speed, Point destination);
+  // Record how a Ship is moving, where it is, and how much fuel it has.
+  void set_state(int slot, Motion_e motion, Point position, double fuel);
+
+  // Compute the step for the next hour for every slot that is moving, sharing the slots
+  // out among the threads of the pool if one is supplied and there are enough of them.
+  void compute_steps(Thread_pool *pool_ptr = nullptr);
+
+  // whether a step has been computed for the slot since its state was last recorded
+  bool has_step(int slot) const
+  {
+    return step_ready[slot];
+  }
+
+  // the results of the step computed for the slot
+  Point get_step_position(int slot) const
+  {
+    return Point(step_x[slot], step_y[slot]);
+  }
+
+  double get_step_fuel(int slot) const
+  {
+    return step_fuel[slot];
+  }
+
+  Outcome_e get_step_outcome(int slot) const
+  {
+    return static_cast<Outcome_e>(step_outcome[slot]);
+  }
+
+private:
+  // the state recorded for each slot
+  std::vector<double> x;
+  std::vector<double> y;
+  std::vector<double> unit_x;       // the course, as a Cartesian_vector of length 1
+  std::vector<double> unit_y;
+  std::vector<double> speed;
+  std::vector<double> fuel;
+  std::vector<double> consumption;
+  std::vector<double> destination_x;
+  std::vector<double> destination_y;
+  std::vector<unsigned char> motion;
+
+  // the step computed for each slot
+  std::vector<double> step_x;
+  std::vector<double> step_y;
+  std::vector<double> step_fuel;
+  std::vector<unsigned char> step_outcome;
+  std::vector<unsigned char> step_ready;
+
+  std::vector<int> free_slots;
+  
+  // compute the steps for the slots from begin up to end
+  void compute_steps_in(int begin, int end);
+};
+
+#endif
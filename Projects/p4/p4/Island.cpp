@@ -8,21 +8,23 @@
 #include "Island.h"
 #include "Model.h"
 #include "Geometry.h"
+#include "Logger.h"
 #include <iostream>
 #include <string>
+#include <limits>
 using namespace std;
 
 // initialize then output constructor message
 Island::Island(const string &name_, Point position_, double fuel_, double production_rate_) :
 Sim_object(name_), position(position_), fuel(fuel_), production_rate(production_rate_)
 {
-  cout << "Island " << get_name() << " constructed" << endl;
+  Log_line(LOG_LIFECYCLE, LOG_DETAILS) << "Island " << get_name() << " constructed";
 }
 
 // output destructor message
 Island::~Island()
 {
-  cout << "Island " << get_name() << " destructed" << endl;
+  Log_line(LOG_LIFECYCLE, LOG_DETAILS) << "Island " << get_name() << " destructed";
 }
 
 // Return whichever is less, the request or the amount left,
@@ -31,7 +33,7 @@ double Island::provide_fuel(double request)
 {
   double min = request < fuel ? request : fuel;
   fuel -= min;
-  cout << "Island " << get_name() << " supplied " << min << " tons of fuel" << endl;
+  Log_line(LOG_CARGO, LOG_EVENTS) << "Island " << get_name() << " supplied " << min << " tons of fuel";
   return min;
 }
 
@@ -39,7 +41,7 @@ double Island::provide_fuel(double request)
 void Island::accept_fuel(double amount)
 {
   fuel += amount;
-  cout << "Island " << get_name() << " now has " << fuel << " tons" << endl;
+  Log_line(LOG_CARGO, LOG_DETAILS) << "Island " << get_name() << " now has " << fuel << " tons";
 }
 
 // if production_rate > 0, compute production_rate * unit time, and add to amount, and print an update message
@@ -47,7 +49,24 @@ void Island::update()
 {
   if (production_rate <= 0) return;
   fuel += production_rate;
-  cout << "Island " << get_name() << " now has " << fuel << " tons" << endl;
+  Log_line(LOG_CARGO, LOG_DETAILS) << "Island " << get_name() << " now has " << fuel << " tons";
+}
+
+// production is routine unless the amounts it leaves are being logged
+int Island::get_num_routine_updates() const
+{
+  if (production_rate > 0 && g_Logger.is_enabled(LOG_CARGO, LOG_DETAILS)) return 0;
+  return numeric_limits<int>::max();
+}
+
+// add the production one update at a time, so the amount is rounded just as update rounds it
+void Island::fast_forward(int num_updates)
+{
+  if (production_rate <= 0) return;
+  for (int i = 0; i < num_updates; i++)
+  {
+    fuel += production_rate;
+  }
 }
 
 // output information about the current state
@@ -32,6 +32,11 @@ public:
   // if production_rate > 0, compute production_rate * unit time, and add to amount, and print an update message
   void update() override;
   
+  // production is routine unless the amounts it leaves are being logged
+  int get_num_routine_updates() const override;
+  
+  void fast_forward(int num_updates) override;
+  
   // output information about the current state
   void describe() const override;
   
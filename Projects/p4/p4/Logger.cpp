@@ -0,0 +1,271 @@
+#include "Logger.h"
+#include <iostream>
+#include <sstream>
+#include <algorithm>
+#include <chrono>
+#include <atomic>
+#include <condition_variable>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <cassert>
+
+using namespace std;
+
+Logger g_Logger(cout);
+
+const unsigned ALL_CATEGORIES = (1u << NUM_LOG_CATEGORIES) - 1;
+// the writer thread is woken when this much text is waiting in a ring, and otherwise writes
+// what is waiting at this interval, or when flush() is called
+const size_t WAKE_WRITER_SIZE = 1 << 14;
+const chrono::milliseconds WRITE_INTERVAL(100);
+
+// each thread's ring, and the Logger it belongs to
+static thread_local Logger* t_ring_logger_ptr = nullptr;
+static thread_local void* t_ring_ptr = nullptr;
+
+// the stream each thread formats its records on, and whether a record is using it
+static thread_local ostringstream t_format_stream;
+static thread_local bool t_format_stream_in_use = false;
+// what a record that is not enabled gives to functions that output to a stream
+static thread_local ostream t_ignored_stream(nullptr);
+
+// output is the stream the records are written to, and whose format they use
+Logger::Logger(ostream& output_) :
+output(output_), current_level(LOG_DETAILS), enabled_categories(ALL_CATEGORIES), stopping(false),
+write_requested(false), writer_waiting(false)
+{}
+
+// Write whatever is still waiting, then stop the writer thread.
+Logger::~Logger()
+{
+  {
+    lock_guard<std::mutex> lock(mutex);
+    stopping = true;
+  }
+  text_added.notify_one();
+  if (writer.joinable())
+  {
+    writer.join();
+  }
+}
+
+void Logger::set_category_enabled(Log_category_e category, bool enabled)
+{
+  if (enabled)
+  {
+    enabled_categories.fetch_or(1u << category, memory_order_relaxed);
+  }
+  else
+  {
+    enabled_categories.fetch_and(~(1u << category), memory_order_relaxed);
+  }
+}
+
+// Give the stream the format of the output stream.
+void Logger::copy_format_to(ostream& os) const
+{
+  os.flags(output.flags());
+  os.precision(output.precision());
+  os.fill(output.fill());
+}
+
+// Add the text of records to this thread's buffer, waiting for room if it is full.
+void Logger::write(const char* text, size_t length)
+{
+  Ring& ring = get_ring();
+  size_t added = ring.added.load(memory_order_relaxed);
+  while (length > 0)
+  {
+    size_t room = RING_SIZE - (added - ring.taken.load(memory_order_acquire));
+    if (room == 0)
+    {
+      // the writer thread is behind, so wait for it to catch up
+      unique_lock<std::mutex> lock(mutex);
+      write_requested = true;
+      text_added.notify_one();
+      text_written.wait(lock, [&ring, added]
+                        {
+                          return ring.taken.load(memory_order_acquire) != added - RING_SIZE;
+                        });
+      continue;
+    }
+    size_t start = added % RING_SIZE;
+    size_t count = min(length, min(room, RING_SIZE - start));
+    memcpy(ring.text + start, text, count);
+    text += count;
+    length -= count;
+    added += count;
+    ring.added.store(added, memory_order_release);
+  }
+  // let the text pile up, so that it is written in large pieces
+  if (added - ring.taken.load(memory_order_relaxed) >= WAKE_WRITER_SIZE)
+  {
+    wake_writer();
+  }
+}
+
+// Return when everything logged so far has been written to the output stream.
+void Logger::flush()
+{
+  unique_lock<std::mutex> lock(mutex);
+  while (is_text_waiting())
+  {
+    write_requested = true;
+    text_added.notify_one();
+    text_written.wait(lock);
+  }
+}
+
+/* Private Function Definitions */
+
+// the ring of the calling thread, made the first time it logs
+Logger::Ring& Logger::get_ring()
+{
+  if (t_ring_logger_ptr == this)
+  {
+    return *static_cast<Ring*>(t_ring_ptr);
+  }
+  lock_guard<std::mutex> lock(mutex);
+  rings.emplace_back(new Ring);
+  if (!writer.joinable())
+  {
+    writer = thread(&Logger::writer_loop, this);
+  }
+  t_ring_logger_ptr = this;
+  t_ring_ptr = rings.back().get();
+  return *rings.back();
+}
+
+// whether any ring has at least the supplied amount of text waiting; call with mutex locked
+bool Logger::is_text_waiting(size_t length) const
+{
+  for (auto&& ring_ptr : rings)
+  {
+    if (ring_ptr->added.load(memory_order_acquire) - ring_ptr->taken.load(memory_order_acquire) >= length)
+    {
+      return true;
+    }
+  }
+  return false;
+}
+
+// Wake the writer thread if it is waiting. The fence here and the one in writer_loop make
+// sure that either the writer thread sees the text just added before it waits, or this sees
+// that it is waiting.
+void Logger::wake_writer()
+{
+  atomic_thread_fence(memory_order_seq_cst);
+  if (writer_waiting.load(memory_order_relaxed))
+  {
+    lock_guard<std::mutex> lock(mutex);
+    text_added.notify_one();
+  }
+}
+
+// what the writer thread runs
+void Logger::writer_loop()
+{
+  vector<Ring*> ring_ptrs;
+  while (true)
+  {
+    {
+      unique_lock<std::mutex> lock(mutex);
+      writer_waiting.store(true, memory_order_relaxed);
+      atomic_thread_fence(memory_order_seq_cst);
+      text_added.wait_for(lock, WRITE_INTERVAL, [this]
+                          {
+                            return stopping || write_requested || is_text_waiting(WAKE_WRITER_SIZE);
+                          });
+      writer_waiting.store(false, memory_order_relaxed);
+      write_requested = false;
+      if (!is_text_waiting())
+      {
+        if (stopping)
+        {
+          return;
+        }
+        continue;
+      }
+      ring_ptrs.clear();
+      for (auto&& ring_ptr : rings)
+      {
+        ring_ptrs.push_back(ring_ptr.get());
+      }
+    }
+    write_rings(ring_ptrs);
+    lock_guard<std::mutex> lock(mutex);
+    text_written.notify_all();
+  }
+}
+
+// Write the text waiting in the rings, then mark it taken. The text is only marked taken
+// once the output stream has been flushed, so that flush() can't return before then.
+void Logger::write_rings(const vector<Ring*>& ring_ptrs)
+{
+  vector<size_t> ends;
+  for (Ring* ring_ptr : ring_ptrs)
+  {
+    size_t begin = ring_ptr->taken.load(memory_order_relaxed);
+    size_t end = ring_ptr->added.load(memory_order_acquire);
+    ends.push_back(end);
+    // the waiting text may run off the end of the ring and on from its start
+    size_t start = begin % RING_SIZE;
+    size_t first_count = min(end - begin, RING_SIZE - start);
+    output.write(ring_ptr->text + start, first_count);
+    output.write(ring_ptr->text, end - begin - first_count);
+  }
+  output.flush();
+  for (size_t i = 0; i < ring_ptrs.size(); i++)
+  {
+    ring_ptrs[i]->taken.store(ends[i], memory_order_release);
+  }
+}
+
+/* Log_line */
+
+Log_line::Log_line(Log_category_e category, Log_level_e level) : stream_ptr(nullptr)
+{
+  if (!g_Logger.is_enabled(category, level))
+  {
+    return;
+  }
+  if (t_format_stream_in_use)
+  {
+    own_stream.reset(new ostringstream);
+    stream_ptr = own_stream.get();
+  }
+  else
+  {
+    t_format_stream_in_use = true;
+    stream_ptr = &t_format_stream;
+  }
+  g_Logger.copy_format_to(*stream_ptr);
+}
+
+Log_line::~Log_line()
+{
+  if (!stream_ptr)
+  {
+    return;
+  }
+  *stream_ptr << '\n';
+  string text = stream_ptr->str();
+  g_Logger.write(text.data(), text.size());
+  if (stream_ptr == &t_format_stream)
+  {
+    t_format_stream.str("");
+    t_format_stream.clear();
+    t_format_stream_in_use = false;
+  }
+}
+
+// the stream the record is being formatted on, for functions that output to a stream;
+// what is output to it is ignored if the record is not enabled
+ostream& Log_line::get_stream()
+{
+  return stream_ptr ? *stream_ptr : t_ignored_stream;
+}
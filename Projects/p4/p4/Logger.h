@@ -0,0 +1,153 @@
+#ifndef LOGGER_H
+#define LOGGER_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <iosfwd>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+// how much is logged: nothing, the events that change what the objects are doing,
+// or also the details that are logged every update and as objects come and go
+enum Log_level_e {LOG_QUIET, LOG_EVENTS, LOG_DETAILS};
+
+// what a record is about; each category can be turned on and off
+enum Log_category_e {LOG_LIFECYCLE, LOG_MOVEMENT, LOG_CARGO, LOG_COMBAT, NUM_LOG_CATEGORIES};
+
+/***** Logger Class *****/
+/* The Logger takes the records the simulation logs and writes them to its output stream on
+ a thread of its own, so that the simulation doesn't wait for the output. Each thread that
+ logs has its own ring buffer, which only it adds to and only the writer thread takes from,
+ so adding a record takes no lock. The writer thread sleeps until a buffer is filling up, a
+ tenth of a second has gone by, or flush() is called, then takes everything waiting in all of
+ the buffers at once, writes it and flushes the stream once. A record is only made if its level and category are enabled, so at the quiet level
+ logging costs a test and nothing else.
+
+ The records from each thread are written in the order they were logged. Anything else
+ written to the output stream must wait for flush(), so that it comes after them.
+ By default everything is logged.
+ */
+
+class Logger {
+public:
+  // output is the stream the records are written to, and whose format they use
+  explicit Logger(std::ostream& output_);
+
+  // Write whatever is still waiting, then stop the writer thread.
+  ~Logger();
+
+  bool is_enabled(Log_category_e category, Log_level_e level) const
+  {
+    return level <= current_level.load(std::memory_order_relaxed) &&
+    (enabled_categories.load(std::memory_order_relaxed) & (1u << category));
+  }
+
+  Log_level_e get_level() const
+  {
+    return Log_level_e(current_level.load(std::memory_order_relaxed));
+  }
+
+  void set_level(Log_level_e level)
+  {
+    current_level.store(level, std::memory_order_relaxed);
+  }
+
+  void set_category_enabled(Log_category_e category, bool enabled);
+
+  // Give the stream the format of the output stream.
+  void copy_format_to(std::ostream& os) const;
+
+  // Add the text of records to this thread's buffer, waiting for room if it is full.
+  void write(const char* text, std::size_t length);
+
+  // Return when everything logged so far has been written to the output stream.
+  void flush();
+
+  // disallow copy/move construction or assignment
+  Logger(const Logger&) = delete;
+  Logger& operator=(const Logger&) = delete;
+
+private:
+  static const std::size_t RING_SIZE = 1 << 16;
+
+  // The text logged by one thread. The counts of the characters added and taken only grow;
+  // their difference is what is waiting, and each modulo RING_SIZE is where it is in text.
+  struct Ring {
+    char text[RING_SIZE];
+    std::atomic<std::size_t> added{0};
+    std::atomic<std::size_t> taken{0};
+  };
+
+  std::ostream& output;
+  std::atomic<int> current_level;
+  std::atomic<unsigned> enabled_categories;
+
+  // mutex guards the list of rings and the starting and stopping of the writer thread
+  std::mutex mutex;
+  std::vector<std::unique_ptr<Ring>> rings;
+  std::thread writer;
+  bool stopping;
+  // set when the text waiting should be written without waiting for more
+  bool write_requested;
+  // set while the writer thread is waiting, so that it is only woken when it needs to be
+  std::atomic<bool> writer_waiting;
+  std::condition_variable text_added;
+  std::condition_variable text_written;
+
+  // the ring of the calling thread, made the first time it logs
+  Ring& get_ring();
+  // whether any ring has at least the supplied amount of text waiting; call with mutex locked
+  bool is_text_waiting(std::size_t length = 1) const;
+  // wake the writer thread if it is waiting
+  void wake_writer();
+  // what the writer thread runs
+  void writer_loop();
+  // write the text waiting in the rings, then mark it taken
+  void write_rings(const std::vector<Ring*>& ring_ptrs);
+};
+
+// the Logger for the simulation, writing to cout
+extern Logger g_Logger;
+
+/***** Log_line Class *****/
+/* A Log_line is one record: if its category and level are enabled, what is output to it is
+ formatted as it would be on the Logger's output stream, and when it is destroyed it is ended
+ with a newline and handed to the Logger. If not, what is output to it is ignored.
+ It is meant to be used as a temporary, e.g.
+   Log_line(LOG_MOVEMENT, LOG_EVENTS) << get_name() << " stopping at " << get_location();
+ */
+
+class Log_line {
+public:
+  Log_line(Log_category_e category, Log_level_e level);
+  ~Log_line();
+
+  template<typename T>
+  Log_line& operator<<(const T& value)
+  {
+    if (stream_ptr)
+    {
+      *stream_ptr << value;
+    }
+    return *this;
+  }
+
+  // the stream the record is being formatted on, for functions that output to a stream;
+  // what is output to it is ignored if the record is not enabled
+  std::ostream& get_stream();
+
+  // disallow copy/move construction or assignment
+  Log_line(const Log_line&) = delete;
+  Log_line& operator=(const Log_line&) = delete;
+
+private:
+  std::ostringstream* stream_ptr;
+  // a record made while another is being made on the same thread has its own stream
+  std::unique_ptr<std::ostringstream> own_stream;
+};
+
+#endif
@@ -1,53 +1,53 @@
 #include "Model.h"
 #include <string>
 #include <map>
-#include <iostream>
 #include <vector>
 #include <functional>
 #include <algorithm>
+#include <queue>
+#include <unordered_map>
+#include <utility>
 #include "Ship.h"
 #include "Island.h"
 #include "View.h"
 #include "Geometry.h"
 #include "Ship_factory.h"
+#include "Thread_pool.h"
+#include "Logger.h"
 
 using namespace std;
 using namespace placeholders;
 
 const char* const ISLAND_NOT_FOUND_MSG = "Island not found!";
 const char* const SHIP_NOT_FOUND_MSG = "Ship not found!";
+// the size of the squares the spatial grid divides the plane into, in nm
+const double GRID_CELL_SIZE = 10.;
+// the initial limits for collision warnings, in nm and hours
+const double INITIAL_WARNING_RANGE = 1.;
+const double INITIAL_TIME_HORIZON = 3.;
 
 Model* g_Model_ptr;
 
 // create the initial objects, output constructor message
-Model::Model() : time(0)
+Model::Model() : time(0), grid(GRID_CELL_SIZE),
+collision_monitor(INITIAL_WARNING_RANGE, INITIAL_TIME_HORIZON)
 {
-  Island *exxon = new Island("Exxon", Point(10, 10), 1000, 200);
-  Island *shell = new Island("Shell", Point(0, 30), 1000, 200);
-  Island *bermuda = new Island("Bermuda", Point(20, 20));
-  
-  string short_exxon = exxon->get_name().substr(0, SHORTEN_NAME_LENGTH);
-  islands[short_exxon] = exxon;
-  objects[short_exxon] = exxon;
-  string short_shell = shell->get_name().substr(0, SHORTEN_NAME_LENGTH);
-  islands[short_shell] = shell;
-  objects[short_shell] = shell;
-  string short_bermuda = bermuda->get_name().substr(0, SHORTEN_NAME_LENGTH);
-  islands[short_bermuda] = bermuda;
-  objects[short_bermuda] = bermuda;
+  add_island(new Island("Exxon", Point(10, 10), 1000, 200));
+  add_island(new Island("Shell", Point(0, 30), 1000, 200));
+  add_island(new Island("Bermuda", Point(20, 20)));
   
   add_ship(create_ship("Ajax", "Cruiser", Point (15, 15)));
   add_ship(create_ship("Xerxes", "Cruiser", Point (25, 25)));
   add_ship(create_ship("Valdez", "Tanker", Point (30, 30)));
   
-  cout << "Model constructed" << endl;
+  Log_line(LOG_LIFECYCLE, LOG_DETAILS) << "Model constructed";
 }
 
 // destroy all objects, output destructor message
 Model::~Model()
 {
   for_each(objects.begin(), objects.end(), [](pair<string, Sim_object*> pair){delete pair.second;});
-  cout << "Model destructed" << endl;
+  Log_line(LOG_LIFECYCLE, LOG_DETAILS) << "Model destructed";
 }
 
 // will throw Error("Island not found!") if no island of that name
@@ -60,12 +60,24 @@ Island* Model::get_island_ptr(const std::string& name) const
   return island;
 }
 
+// add a new island to the list, and update the view
+void Model::add_island(Island* island)
+{
+  string shortened_name = island->get_name().substr(0, SHORTEN_NAME_LENGTH);
+  islands[shortened_name] = island;
+  objects[shortened_name] = island;
+  grid.set_location(island, island->get_location());
+  notify_location(island->get_name(), island->get_location());
+}
+
 // add a new ship to the list, and update the view
 void Model::add_ship(Ship* ship)
 {
   string shortened_name = ship->get_name().substr(0, SHORTEN_NAME_LENGTH);
   ships[shortened_name] = ship;
   objects[shortened_name] = ship;
+  ship->join_fleet(&fleet);
+  grid.set_location(ship, ship->get_location());
   notify_location(ship->get_name(), ship->get_location());
 }
 // will throw Error("Ship not found!") if no ship of that name
@@ -78,15 +90,40 @@ Ship* Model::get_ship_ptr(const std::string& name) const
   return ship;
 }
 
+// order objects by name
+static bool name_less(const Sim_object *lhs, const Sim_object *rhs)
+{
+  return lhs->get_name() < rhs->get_name();
+}
+
+// the objects whose distance from the center is no more than the radius, in name order
+vector<Sim_object*> Model::objects_within(Point center, double radius) const
+{
+  vector<Sim_object*> found = grid.objects_within(center, radius);
+  sort(found.begin(), found.end(), name_less);
+  return found;
+}
+
+// the objects inside the rectangle with the supplied corners, or on its edges, in name order
+vector<Sim_object*> Model::objects_in_rect(Point lower_left, Point upper_right) const
+{
+  vector<Sim_object*> found = grid.objects_in_rect(lower_left, upper_right);
+  sort(found.begin(), found.end(), name_less);
+  return found;
+}
+
 // tell all objects to describe themselves
 void Model::describe() const
 {
   for_each(objects.begin(), objects.end(), [](pair<string, Sim_object*> pair){pair.second->describe();});
 }
 // increment the time, and tell all objects to update themselves
+// The steps of all of the moving ships are computed in one pass first,
+// and each ship takes its own step when it is updated.
 void Model::update()
 {
   ++time;
+  fleet.compute_steps(pool.get());
   for_each(objects.begin(), objects.end(), [](pair<string, Sim_object*> pair){pair.second->update();});
   vector<Ship*> dead_ships;
   for (auto&& ship_pair : ships)
@@ -98,10 +135,170 @@ void Model::update()
   }
   for (auto&& dead_ship : dead_ships)
   {
-    objects.erase(dead_ship->get_name().substr(0, SHORTEN_NAME_LENGTH));
-    ships.erase(dead_ship->get_name().substr(0, SHORTEN_NAME_LENGTH));
-    delete dead_ship;
+    remove_ship(dead_ship);
+  }
+  monitor_collisions();
+}
+
+/*
+ advance keeps a schedule with an entry for each object, in the order update updates them,
+ holding the hour up to which the object has been updated and the next hour in which it must
+ really be updated, the one after its routine updates. It jumps from one such hour to the
+ next. In each, the objects due then, and the objects they may look at or change, are
+ fast-forwarded to the hour before, then updated in the same order as update would, so they
+ find each other just as they would have, and then rescheduled, since they may have changed.
+ Any other object would only have made a routine update in that hour, which changes nothing
+ but itself, so it is left to be made when the object is next fast-forwarded. In an hour in
+ which every object is due, the Fleet computes the steps, as it does for update.
+ At the end, every object is fast-forwarded to the last hour, and the collision monitor is
+ run once, since its warnings are not looked at in between.
+ */
+void Model::advance(int hours)
+{
+  struct Schedule_entry {
+    Sim_object* object;     // nullptr once the object has been destroyed
+    Ship* ship;             // the object, if it is a ship
+    int updated_to;         // the hour up to which the object has been updated
+    int next_update;        // the next hour in which the object must be updated
+  };
+  if (hours == 1)
+  {
+    update();
+    return;
+  }
+  int end_time = time + hours;
+  vector<Schedule_entry> schedule;
+  schedule.reserve(objects.size());
+  unordered_map<Sim_object*, int> entry_indices(objects.size());
+  // the hours the entries are due in, soonest first; an entry rescheduled since it was
+  // added here is only due in the hour its next_update says
+  typedef pair<int, int> Hour_entry_t;
+  priority_queue<Hour_entry_t, vector<Hour_entry_t>, greater<Hour_entry_t>> due;
+  auto reschedule = [&](int index) {
+    Schedule_entry& entry = schedule[index];
+    long long next_update = entry.updated_to + (long long)entry.object->get_num_routine_updates() + 1;
+    if (next_update <= end_time)
+    {
+      entry.next_update = int(next_update);
+      due.push(Hour_entry_t(entry.next_update, index));
+    }
+    else
+    {
+      entry.next_update = end_time + 1;
+    }
+  };
+  auto fast_forward_to = [](Schedule_entry& entry, int hour) {
+    if (hour > entry.updated_to)
+    {
+      entry.object->fast_forward(hour - entry.updated_to);
+      entry.updated_to = hour;
+    }
+  };
+  
+  for (auto&& object_pair : objects)
+  {
+    auto ship_it = ships.find(object_pair.first);
+    entry_indices[object_pair.second] = int(schedule.size());
+    schedule.push_back(Schedule_entry{object_pair.second, ship_it != ships.end() ? ship_it->second : nullptr, time, 0});
+    reschedule(int(schedule.size()) - 1);
+  }
+  int num_remaining = int(schedule.size());
+  vector<int> hour_indices;
+  vector<Sim_object*> partners;
+  while (!due.empty())
+  {
+    int hour = due.top().first;
+    hour_indices.clear();
+    partners.clear();
+    for (; !due.empty() && due.top().first == hour; due.pop())
+    {
+      Schedule_entry& entry = schedule[due.top().second];
+      if (entry.object && entry.next_update == hour)
+      {
+        hour_indices.push_back(due.top().second);
+        entry.object->add_partners(partners);
+      }
+    }
+    for (auto&& partner : partners)
+    {
+      auto index_it = entry_indices.find(partner);
+      if (index_it != entry_indices.end())
+      {
+        hour_indices.push_back(index_it->second);
+      }
+    }
+    if (hour_indices.empty()) continue;
+    sort(hour_indices.begin(), hour_indices.end());
+    hour_indices.erase(unique(hour_indices.begin(), hour_indices.end()), hour_indices.end());
+    
+    for (int index : hour_indices)
+    {
+      fast_forward_to(schedule[index], hour - 1);
+    }
+    time = hour;
+    if (int(hour_indices.size()) == num_remaining)
+    {
+      fleet.compute_steps(pool.get());
+    }
+    for (int index : hour_indices)
+    {
+      schedule[index].object->update();
+    }
+    for (int index : hour_indices)
+    {
+      Schedule_entry& entry = schedule[index];
+      entry.updated_to = hour;
+      if (entry.ship && entry.ship->is_on_the_bottom())
+      {
+        entry_indices.erase(entry.object);
+        remove_ship(entry.ship);
+        entry.object = nullptr;
+        entry.ship = nullptr;
+        num_remaining--;
+      }
+      else
+      {
+        reschedule(index);
+      }
+    }
+  }
+  
+  for (auto&& entry : schedule)
+  {
+    if (entry.object)
+    {
+      fast_forward_to(entry, end_time);
+    }
   }
+  time = end_time;
+  monitor_collisions();
+}
+
+// Compute the movement of the ships on this many threads from now on
+void Model::set_num_threads(int num_threads)
+{
+  pool.reset(num_threads > 1 ? new Thread_pool(num_threads) : nullptr);
+}
+
+// take the ship out of the containers and the grid, and destroy it
+void Model::remove_ship(Ship* ship)
+{
+  objects.erase(ship->get_name().substr(0, SHORTEN_NAME_LENGTH));
+  ships.erase(ship->get_name().substr(0, SHORTEN_NAME_LENGTH));
+  grid.remove(ship);
+  delete ship;
+}
+
+// find the ships at risk of collision as they are now
+void Model::monitor_collisions()
+{
+  vector<const Ship*> remaining_ships;
+  remaining_ships.reserve(ships.size());
+  for (auto&& ship_pair : ships)
+  {
+    remaining_ships.push_back(ship_pair.second);
+  }
+  collision_monitor.update(remaining_ships);
 }
 
 /* View services */
@@ -119,13 +316,23 @@ void Model::detach(View* view)
   views.erase(find(views.begin(), views.end(), view));
 }
 
-// notify the views about an object's location
+// notify the views about an object's location, and move it in the grid
 void Model::notify_location(const std::string& name, Point location)
 {
+  auto object_it = objects.find(name.substr(0, SHORTEN_NAME_LENGTH));
+  if (object_it != objects.end())
+  {
+    grid.set_location(object_it->second, location);
+  }
   for_each(views.begin(), views.end(), bind(&View::update_location, _1, name, location));
 }
-// notify the views that an object is now gone
+// notify the views that an object is now gone, and take it out of the grid
 void Model::notify_gone(const std::string& name)
 {
+  auto object_it = objects.find(name.substr(0, SHORTEN_NAME_LENGTH));
+  if (object_it != objects.end())
+  {
+    grid.remove(object_it->second);
+  }
   for_each(views.begin(), views.end(), bind(&View::update_remove, _1, name));
 }
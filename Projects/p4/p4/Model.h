@@ -4,12 +4,17 @@
 #include <string>
 #include <map>
 #include <vector>
+#include <memory>
 #include "Utility.h"
+#include "Fleet.h"
+#include "Spatial_grid.h"
+#include "Collision_monitor.h"
 
 class Sim_object;
 class Ship;
 class Island;
 class View;
+class Thread_pool;
 struct Point;
 
 /*
@@ -40,6 +45,9 @@ public:
   // return the current time
   int get_time() {return time;}
   
+  // return the number of ships and islands
+  int get_num_objects() const {return int(objects.size());}
+  
   // is name already in use for either ship or island?
   // either the identical name, or identical in first two characters counts as in-use
   bool is_name_in_use(const std::string& name) const
@@ -54,6 +62,8 @@ public:
   }
   // will throw Error("Island not found!") if no island of that name
   Island* get_island_ptr(const std::string& name) const;
+  // add a new island to the list, and update the view
+  void add_island(Island*);
   
   // is there such an ship?
   bool is_ship_present(const std::string& name) const
@@ -65,10 +75,45 @@ public:
   // will throw Error("Ship not found!") if no ship of that name
   Ship* get_ship_ptr(const std::string& name) const;
   
+  // the objects whose distance from the center is no more than the radius, in name order
+  std::vector<Sim_object*> objects_within(Point center, double radius) const;
+  // the objects inside the rectangle with the supplied corners, or on its edges, in name order
+  std::vector<Sim_object*> objects_in_rect(Point lower_left, Point upper_right) const;
+  
   // tell all objects to describe themselves
   void describe() const;
   // increment the time, and tell all objects to update themselves
   void update();
+  // Advance the time by the supplied number of hours, with the same results as calling update
+  // that many times, but update each object only in the hours it does something that is not
+  // routine, fast-forward it through the rest, and skip the hours in which nothing else happens.
+  void advance(int hours);
+  
+  /* Collision warnings */
+  // the pairs of ships whose CPA was within the warning range and time horizon
+  // at the end of the last update, in order of the ships' names
+  const std::vector<Collision_monitor::Warning>& get_collision_warnings() const
+  {
+    return collision_monitor.get_warnings();
+  }
+  double get_warning_range() const
+  {
+    return collision_monitor.get_warning_range();
+  }
+  double get_time_horizon() const
+  {
+    return collision_monitor.get_time_horizon();
+  }
+  // use these limits for the warnings from the next update on; they must not be negative
+  void set_warning_limits(double warning_range, double time_horizon)
+  {
+    collision_monitor.set_limits(warning_range, time_horizon);
+  }
+  
+  // Compute the movement of the ships on this many threads from now on; with 1, it is
+  // computed on this thread alone. Everything else an update does happens on this thread,
+  // in the same order, so the results are exactly the same for any number of threads.
+  void set_num_threads(int num_threads);
   
   /* View services */
   // Attaching a View adds it to the container and causes it to be updated
@@ -95,6 +140,20 @@ private:
   std::map<std::string, Sim_object*> objects;
   
   std::vector<View*> views;
+  
+  // the movement state of all of the ships, so that their steps are computed together
+  Fleet fleet;
+  // the threads the steps are computed on, if more than one
+  std::unique_ptr<Thread_pool> pool;
+  // where the objects are, kept up to date from notify_location
+  Spatial_grid grid;
+  // the ships at risk of collision, found at the end of each update
+  Collision_monitor collision_monitor;
+  
+  // take the ship out of the containers and the grid, and destroy it
+  void remove_ship(Ship*);
+  // find the ships at risk of collision as they are now
+  void monitor_collisions();
 };
 
 #endif
@@ -219,5 +219,9 @@ Compass_position compute_CPA(Course_speed ownship_cs, Course_speed target_cs, Co
 		}
 }
 
-
-
+// *** to_unit_Cartesian_vector ***
+// Return the Cartesian_vector for one nm along a compass course.
+Cartesian_vector to_unit_Cartesian_vector(double course)
+{
+	return Cartesian_vector(to_Polar_vector(Compass_vector(course, 1.)));
+}
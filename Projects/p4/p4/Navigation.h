@@ -65,6 +65,7 @@ the Compass_vector for its course and the time to get its new Point:
 // forward declarations
 struct Point;
 struct Polar_vector;
+struct Cartesian_vector;
 struct Course_speed;
 struct Compass_position;
 struct Compass_vector;
@@ -89,7 +90,7 @@ struct Compass_position
 };
 
 /* Course_speed */
-// Course_speed describes a compass course and speed. 
+// Course_speed describes a compass course and speed.
 // A Course_speed can not be constructed from any other object.
 struct Course_speed
 {
@@ -148,5 +149,10 @@ std::ostream& operator<< (std::ostream& os, const Compass_vector& cv);
 // If the CPA is the current position, it is returned with the time being zero.
 Compass_position compute_CPA(Course_speed ownship_cs, Course_speed target_cs, Compass_position target_position_cp, double& time_to_CPA);
 
+// Return the Cartesian_vector for one nm along a compass course. Multiplying its components
+// by a distance gives exactly the displacement that adding a Compass_vector of that course
+// and distance to a Point produces.
+Cartesian_vector to_unit_Cartesian_vector(double course);
+
 
 #endif
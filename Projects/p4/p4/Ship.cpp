@@ -4,23 +4,32 @@
 #include "Navigation.h"
 #include "Utility.h"
 #include "Island.h"
+#include "Fleet.h"
+#include "Logger.h"
 #include <string>
 #include <sstream>
 #include <iostream>
+#include <limits>
+#include <algorithm>
+#include <cmath>
 #include <cassert>
 
 using namespace std;
 
 const char* const CANNOT_ATTACK_MSG = "Cannot attack!";
 const int SHIP_DOCK_DISTANCE = .1;
+// a bound on how far the rounding in one step can take the position or the fuel from the
+// exact value, as a fraction of the largest magnitude involved, with plenty to spare
+const double ROUNDING_PER_STEP = 1e-14;
 
 Ship::Ship(const string &name_, Point position_, double fuel_capacity_,
            double maximum_speed_, double fuel_consumption_, int resistance_) :
 Sim_object(name_), Track_base(position_, Course_speed(0, 0)), fuel(fuel_capacity_),
 fuel_consumption(fuel_consumption_), fuel_capacity(fuel_capacity_), max_speed(maximum_speed_),
-resistance(resistance_), ship_state(State_ship::STOPPED), docked_at(nullptr)
+resistance(resistance_), ship_state(State_ship::STOPPED), docked_at(nullptr), fleet_ptr(nullptr),
+fleet_slot(0)
 {
-  cout << "Ship " << get_name() << " constructed" << endl;
+  Log_line(LOG_LIFECYCLE, LOG_DETAILS) << "Ship " << get_name() << " constructed";
 }
 
 /*
@@ -33,7 +42,11 @@ resistance(resistance_), ship_state(State_ship::STOPPED), docked_at(nullptr)
 
 Ship::~Ship()
 {
-  cout << "Ship "  << get_name() << " destructed" << endl;
+  if (fleet_ptr)
+  {
+    fleet_ptr->remove_slot(fleet_slot);
+  }
+  Log_line(LOG_LIFECYCLE, LOG_DETAILS) << "Ship "  << get_name() << " destructed";
 }
 
 // Return true if the ship is Stopped and the distance to the supplied island
@@ -53,7 +66,8 @@ void Ship::update()
     ship_state = State_ship::SINKING;
     docked_at = nullptr;
     set_speed(0);
-    cout << get_name() << " sinking" << endl;
+    record_state();
+    Log_line(LOG_COMBAT, LOG_EVENTS) << get_name() << " sinking";
     return;
   }
   switch(ship_state)
@@ -61,27 +75,35 @@ void Ship::update()
     case State_ship::SINKING:
       ship_state = State_ship::SUNK;
       g_Model_ptr->notify_gone(get_name());
-      cout << get_name() << " sunk" << endl;
+      Log_line(LOG_COMBAT, LOG_EVENTS) << get_name() << " sunk";
       break;
     case State_ship::SUNK:
       ship_state = State_ship::ON_THE_BOTTOM;
     case State_ship::ON_THE_BOTTOM:
-      cout << get_name() << " on the bottom" << endl;
+      Log_line(LOG_COMBAT, LOG_DETAILS) << get_name() << " on the bottom";
       break;
     case State_ship::MOVING_ON_COURSE:
     case State_ship::MOVING_TO_POSITION:
-      calculate_movement();
+      if (fleet_ptr && fleet_ptr->has_step(fleet_slot))
+      {
+        take_fleet_step();
+      }
+      else
+      {
+        calculate_movement();
+      }
+      record_state();
       g_Model_ptr->notify_location(get_name(), get_location());
-      cout << get_name() << " now at " << get_location() << endl;
+      Log_line(LOG_MOVEMENT, LOG_DETAILS) << get_name() << " now at " << get_location();
       break;
     case State_ship::STOPPED:
-      cout << get_name() << " stopped at " << get_location() << endl;
+      Log_line(LOG_MOVEMENT, LOG_DETAILS) << get_name() << " stopped at " << get_location();
       break;
     case State_ship::DOCKED:
-      cout << get_name() << " docked at " << get_docked_Island()->get_name() << endl;
+      Log_line(LOG_MOVEMENT, LOG_DETAILS) << get_name() << " docked at " << get_docked_Island()->get_name();
       break;
     case State_ship::DEAD_IN_THE_WATER:
-      cout << get_name() << " dead in the water at " << get_location() << endl;
+      Log_line(LOG_MOVEMENT, LOG_DETAILS) << get_name() << " dead in the water at " << get_location();
       break;
   }
 }
@@ -109,12 +131,12 @@ void Ship::describe() const
   {
     case State_ship::MOVING_TO_POSITION:
       cout << "Moving to " << destination << " on ";
-      print_course_and_speed();
+      print_course_and_speed(cout);
       cout << endl;
       break;
     case State_ship::MOVING_ON_COURSE:
       cout << "Moving on ";
-      print_course_and_speed();
+      print_course_and_speed(cout);
       cout << endl;
       break;
     case State_ship::DOCKED:
@@ -138,6 +160,54 @@ void Ship::broadcast_current_state()
   g_Model_ptr->notify_location(get_name(), get_location());
 }
 
+/*
+ A moving Ship's updates are routine until the step in which it would arrive or run out of
+ fuel. The number of full steps before then is worked out from the distance and the fuel,
+ and cut by the steps that the rounding in that many steps could be worth, and by two more,
+ for the step in which the change happens and for the rounding in the count itself. Only the
+ steps that are sure to be full ones are counted, so update still makes the change itself.
+ */
+int Ship::get_num_routine_updates() const
+{
+  if (!is_afloat() || resistance < 0 || g_Logger.is_enabled(LOG_MOVEMENT, LOG_DETAILS)) return 0;
+  if (!is_moving()) return numeric_limits<int>::max();
+  double speed = get_speed();
+  if (speed <= 0.) return 0;
+  double full_fuel_required = speed * fuel_consumption;
+  double max_steps = numeric_limits<int>::max() / 2;
+  double fuel_steps = full_fuel_required > 0. ? min(fuel / full_fuel_required, max_steps) : max_steps;
+  double steps = fuel_steps;
+  double destination_distance = 0.;
+  if (ship_state == State_ship::MOVING_TO_POSITION)
+  {
+    destination_distance = cartesian_distance(get_location(), destination);
+    steps = min(steps, destination_distance / speed);
+  }
+  // the rounding in the position is worth so many steps of the speed, and in the fuel so many
+  // steps of the fuel used
+  Point location = get_location();
+  double magnitude = max(fabs(location.x), fabs(location.y)) + destination_distance + steps * speed;
+  double rounding_steps = steps * ROUNDING_PER_STEP * (magnitude / speed + fuel_steps);
+  double routine_steps = floor(steps - rounding_steps) - 2.;
+  return routine_steps > 0. ? int(routine_steps) : 0;
+}
+
+// Make the moves calculate_movement makes when the Ship keeps moving, one step at a time,
+// so the position and fuel are rounded just as update rounds them.
+void Ship::fast_forward(int num_updates)
+{
+  if (!is_moving() || num_updates <= 0) return;
+  double time = 1.0;
+  double full_fuel_required = get_speed() * time * fuel_consumption;
+  for (int i = 0; i < num_updates; i++)
+  {
+    update_position(time);
+    fuel -= full_fuel_required;
+  }
+  record_state();
+  g_Model_ptr->notify_location(get_name(), get_location());
+}
+
 /*** Command functions ***/
 // Start moving to a destination position at a speed
 // may throw Error("Ship cannot move!")
@@ -151,9 +221,12 @@ void Ship::set_destination_position_and_speed(Point destination_position, double
   set_speed(speed);
   ship_state = State_ship::MOVING_TO_POSITION;
   docked_at = nullptr;
-  cout << get_name() << " will sail on ";
-  print_course_and_speed();
-  cout << " to " << destination << endl;
+  record_course();
+  record_state();
+  Log_line line(LOG_MOVEMENT, LOG_EVENTS);
+  line << get_name() << " will sail on ";
+  print_course_and_speed(line.get_stream());
+  line << " to " << destination;
 }
 
 // Start moving on a course and speed
@@ -166,9 +239,11 @@ void Ship::set_course_and_speed(double course, double speed)
   set_speed(speed);
   ship_state = State_ship::MOVING_ON_COURSE;
   docked_at = nullptr;
-  cout << get_name() << " will sail on ";
-  print_course_and_speed();
-  cout << endl;
+  record_course();
+  record_state();
+  Log_line line(LOG_MOVEMENT, LOG_EVENTS);
+  line << get_name() << " will sail on ";
+  print_course_and_speed(line.get_stream());
 }
 
 // Stop moving
@@ -182,7 +257,8 @@ void Ship::stop()
   set_speed(0);
   ship_state = State_ship::STOPPED;
   docked_at = nullptr;
-  cout << get_name() << " stopping at " << get_location() << endl;
+  record_state();
+  Log_line(LOG_MOVEMENT, LOG_EVENTS) << get_name() << " stopping at " << get_location();
 }
 
 // dock at an Island - set our position = Island's position, go into Docked state
@@ -197,8 +273,9 @@ void Ship::dock(Island *island_ptr)
   Track_base::set_position(island_ptr->get_location());
   docked_at = island_ptr;
   ship_state = State_ship::DOCKED;
+  record_state();
   g_Model_ptr->notify_location(get_name(), get_location());
-  cout << get_name() << " docked at " << island_ptr->get_name() << endl;
+  Log_line(LOG_MOVEMENT, LOG_EVENTS) << get_name() << " docked at " << island_ptr->get_name();
 }
 
 // Refuel - must already be docked at an island; fill takes as much as possible
@@ -213,10 +290,12 @@ void Ship::refuel()
   if (fuel_needed < REFUEL_MIN)
   {
     fuel = fuel_capacity;
+    record_state();
     return;
   }
   fuel += docked_at->provide_fuel(fuel_needed);
-  cout << get_name() << " now has " << fuel << " tons of fuel" << endl;
+  record_state();
+  Log_line(LOG_CARGO, LOG_EVENTS) << get_name() << " now has " << fuel << " tons of fuel";
 }
 
 /*** Fat interface command functions ***/
@@ -245,12 +324,22 @@ void Ship::stop_attack()
   throw Error(CANNOT_ATTACK_MSG);
 }
 
+// Keep this Ship's movement state in a slot of the Fleet from now on
+void Ship::join_fleet(Fleet *fleet_ptr_)
+{
+  assert(fleet_ptr_ && !fleet_ptr);
+  fleet_ptr = fleet_ptr_;
+  fleet_slot = fleet_ptr->add_slot(fuel_consumption);
+  record_course();
+  record_state();
+}
+
 // interactions with other objects
 // receive a hit from an attacker
 void Ship::receive_hit(int hit_force, Ship *attacker_ptr)
 {
   resistance -= hit_force;
-  cout << get_name() << " hit with " << hit_force << ", resistance now " << resistance << endl;
+  Log_line(LOG_COMBAT, LOG_EVENTS) << get_name() << " hit with " << hit_force << ", resistance now " << resistance;
 }
 
 /* Private Function Definitions */
@@ -322,6 +411,55 @@ void Ship::calculate_movement()
   }
 }
 
+// Take the step the Fleet computed for this update. The Fleet computed it just as
+// calculate_movement would have, so only the outcome needs to be acted on here.
+void Ship::take_fleet_step()
+{
+  set_position(fleet_ptr->get_step_position(fleet_slot));
+  fuel = fleet_ptr->get_step_fuel(fleet_slot);
+  switch (fleet_ptr->get_step_outcome(fleet_slot))
+  {
+    case Fleet::ARRIVED:
+      set_speed(0.);
+      ship_state = State_ship::STOPPED;
+      break;
+    case Fleet::OUT_OF_FUEL:
+      set_speed(0.);
+      ship_state = State_ship::DEAD_IN_THE_WATER;
+      break;
+    case Fleet::KEEPS_MOVING:
+      break;
+  }
+}
+
+// Record the course, speed and destination in the Fleet slot, if any
+void Ship::record_course()
+{
+  if (fleet_ptr)
+  {
+    fleet_ptr->set_course(fleet_slot, get_course_speed(), destination);
+  }
+}
+
+// Record the movement state, position and fuel in the Fleet slot, if any
+void Ship::record_state()
+{
+  if (!fleet_ptr)
+  {
+    return;
+  }
+  Fleet::Motion_e motion = Fleet::NOT_MOVING;
+  if (ship_state == State_ship::MOVING_ON_COURSE)
+  {
+    motion = Fleet::MOVING_ON_COURSE;
+  }
+  else if (ship_state == State_ship::MOVING_TO_POSITION)
+  {
+    motion = Fleet::MOVING_TO_POSITION;
+  }
+  fleet_ptr->set_state(fleet_slot, motion, get_location(), fuel);
+}
+
 // Check if the ship can move and the speed is within the max, and throws errors otherwise
 void Ship::check_movement_and_speed(double speed)
 {
@@ -335,8 +473,8 @@ void Ship::check_movement_and_speed(double speed)
   }
 }
 
-// Prints the course and speed
-void Ship::print_course_and_speed() const
+// Prints the course and speed to the stream
+void Ship::print_course_and_speed(ostream& os) const
 {
-  cout << "course " << get_course() << " deg, speed " << get_speed() << " nm/hr";
+  os << "course " << get_course() << " deg, speed " << get_speed() << " nm/hr";
 }
@@ -6,8 +6,10 @@
 #include "Model.h"
 #include "Geometry.h"
 #include <string>
+#include <iosfwd>
 
 class Island;
+class Fleet;
 
 /***** Ship Class *****/
 /* A Ship has a name, initial position, amount of fuel, and parameters that govern its movement.
@@ -66,6 +68,12 @@ public:
     return ship_state != State_ship::SINKING && ship_state != State_ship::SUNK && ship_state != State_ship::ON_THE_BOTTOM;
   }
   
+  // return the current amount of fuel
+  double get_fuel() const
+  {
+    return fuel;
+  }
+  
   // Return true if ship is on the bottom
   bool is_on_the_bottom() const
   {
@@ -85,6 +93,12 @@ public:
   
   void broadcast_current_state() override;
   
+  // Moving on without arriving or running out of fuel is routine, as is staying put,
+  // unless the movement is being logged; anything to do with sinking is not.
+  int get_num_routine_updates() const override;
+  
+  void fast_forward(int num_updates) override;
+  
   /*** Command functions ***/
   // Start moving to a destination position at a speed
   // may throw Error("Ship cannot move!")
@@ -126,6 +140,11 @@ public:
   // receive a hit from an attacker
   virtual void receive_hit(int hit_force, Ship *attacker_ptr);
   
+  // Keep this Ship's movement state in a slot of the Fleet from now on, so that the Fleet can
+  // compute its steps along with those of the rest of the Fleet. The slot is given back when
+  // the Ship is destroyed. A Ship not in a Fleet computes its own steps.
+  void join_fleet(Fleet *fleet_ptr_);
+  
   // disallow copy/move, construction or assignment
   Ship(const Ship&) = delete;
   Ship& operator=(const Ship&) = delete;
@@ -155,15 +174,26 @@ private:
   
   State_ship ship_state;                   // Current state of the ship
   Island *docked_at;                     // If docked, the island the ship is docked at
+  Fleet *fleet_ptr;                      // The Fleet holding the ship's slot, if any
+  int fleet_slot;                        // The ship's slot in the Fleet
   
   // Updates position, fuel, and movement_state, assuming 1 time unit (1 hr)
   void calculate_movement();
   
+  // Take the step the Fleet computed for this update, which is what calculate_movement would do
+  void take_fleet_step();
+  
+  // Record the course, speed and destination in the Fleet slot, if any
+  void record_course();
+  
+  // Record the movement state, position and fuel in the Fleet slot, if any
+  void record_state();
+  
   // Check if the ship can move and the speed is within the max, and throws errors otherwise
   void check_movement_and_speed(double speed);
   
-  // Prints the course and speed
-  void print_course_and_speed() const;
+  // Prints the course and speed to the stream
+  void print_course_and_speed(std::ostream& os) const;
   
 };
 
@@ -6,17 +6,17 @@
 //  Copyright © 2017 Jay Chow. All rights reserved.
 //
 #include "Sim_object.h"
+#include "Logger.h"
 #include <string>
-#include <iostream>
 
 using namespace std;
 
 Sim_object::Sim_object(const std::string& name_) : name(name_)
 {
-  cout << "Sim_object " << get_name() << " constructed" << endl;
+  Log_line(LOG_LIFECYCLE, LOG_DETAILS) << "Sim_object " << get_name() << " constructed";
 }
 
 Sim_object::~Sim_object()
 {
-  cout << "Sim_object " << get_name() << " destructed" << endl;
+  Log_line(LOG_LIFECYCLE, LOG_DETAILS) << "Sim_object " << get_name() << " destructed";
 }
@@ -5,6 +5,7 @@
  and other information. */
 
 #include <string>
+#include <vector>
 
 struct Point;
 
@@ -25,6 +26,16 @@ public:
   virtual void describe() const = 0;
   virtual void update() = 0;
   
+  /* Fast-forwarding */
+  // An update is routine if all it does is change the object itself, the same way each
+  // time, without logging anything or looking at any other object.
+  // Return how many of the next updates are sure to be routine; by default, none are.
+  virtual int get_num_routine_updates() const {return 0;}
+  // Make the supplied number of routine updates, with exactly the results of update.
+  virtual void fast_forward(int num_updates) {}
+  // Add the objects the next update may look at or change to the vector.
+  virtual void add_partners(std::vector<Sim_object*>& partners) const {}
+  
 private:
   std::string name;
 };
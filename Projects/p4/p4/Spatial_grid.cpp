@@ -0,0 +1,179 @@
+#include "Spatial_grid.h"
+#include "Geometry.h"
+#include <unordered_map>
+#include <vector>
+#include <cmath>
+#include <cassert>
+#include <climits>
+
+using namespace std;
+
+// the cell size must be positive
+Spatial_grid::Spatial_grid(double cell_size_) : cell_size(cell_size_)
+{
+  assert(cell_size > 0.);
+}
+
+// Add the object at the location, or move it there if it is already in the grid.
+void Spatial_grid::set_location(Sim_object *object_ptr, Point location)
+{
+  Cell_key_t key = cell_key(cell_index(location.x), cell_index(location.y));
+  auto object_it = cells_by_object.find(object_ptr);
+  if (object_it != cells_by_object.end())
+  {
+    if (object_it->second == key)
+    {
+      // it is still in the same cell, so only its location changes
+      for (Entry& entry : cells[key])
+      {
+        if (entry.object_ptr == object_ptr)
+        {
+          entry.location = location;
+          return;
+        }
+      }
+    }
+    remove_entry(object_it->second, object_ptr);
+    object_it->second = key;
+  }
+  else
+  {
+    cells_by_object[object_ptr] = key;
+  }
+  cells[key].push_back(Entry{object_ptr, location});
+}
+
+// Remove the object; nothing happens if it isn't in the grid.
+void Spatial_grid::remove(Sim_object *object_ptr)
+{
+  auto object_it = cells_by_object.find(object_ptr);
+  if (object_it == cells_by_object.end())
+  {
+    return;
+  }
+  remove_entry(object_it->second, object_ptr);
+  cells_by_object.erase(object_it);
+}
+
+// the objects whose distance from the center is no more than the radius
+vector<Sim_object*> Spatial_grid::objects_within(Point center, double radius) const
+{
+  vector<Sim_object*> found;
+  if (radius < 0.)
+  {
+    return found;
+  }
+  for_each_entry_in(Point(center.x - radius, center.y - radius), Point(center.x + radius, center.y + radius),
+                    [&found, center, radius](const Entry& entry)
+                    {
+                      if (cartesian_distance(center, entry.location) <= radius)
+                      {
+                        found.push_back(entry.object_ptr);
+                      }
+                    });
+  return found;
+}
+
+// the objects inside the rectangle with the supplied corners, or on its edges
+vector<Sim_object*> Spatial_grid::objects_in_rect(Point lower_left, Point upper_right) const
+{
+  vector<Sim_object*> found;
+  if (lower_left.x > upper_right.x || lower_left.y > upper_right.y)
+  {
+    return found;
+  }
+  for_each_entry_in(lower_left, upper_right,
+                    [&found, lower_left, upper_right](const Entry& entry)
+                    {
+                      if (entry.location.x >= lower_left.x && entry.location.x <= upper_right.x &&
+                          entry.location.y >= lower_left.y && entry.location.y <= upper_right.y)
+                      {
+                        found.push_back(entry.object_ptr);
+                      }
+                    });
+  return found;
+}
+
+/* Private Function Definitions */
+
+// the index of the column or row of cells a coordinate is in; coordinates too far out
+// for an int share the cells at the ends
+int Spatial_grid::cell_index(double coordinate) const
+{
+  double index = floor(coordinate / cell_size);
+  if (index < INT_MIN)
+  {
+    return INT_MIN;
+  }
+  if (index > INT_MAX)
+  {
+    return INT_MAX;
+  }
+  return int(index);
+}
+
+// the key of the cell in a column and row
+Spatial_grid::Cell_key_t Spatial_grid::cell_key(int column, int row)
+{
+  return Cell_key_t((static_cast<unsigned long long>(static_cast<unsigned int>(column)) << 32) |
+                    static_cast<unsigned int>(row));
+}
+
+// remove the object's entry from the cell, and the cell if it is then empty
+void Spatial_grid::remove_entry(Cell_key_t key, Sim_object *object_ptr)
+{
+  auto cell_it = cells.find(key);
+  assert(cell_it != cells.end());
+  vector<Entry>& entries = cell_it->second;
+  for (size_t i = 0; i < entries.size(); i++)
+  {
+    if (entries[i].object_ptr == object_ptr)
+    {
+      entries[i] = entries.back();
+      entries.pop_back();
+      break;
+    }
+  }
+  if (entries.empty())
+  {
+    cells.erase(cell_it);
+  }
+}
+
+// Call found for each entry in the cells that overlap the rectangle. If the rectangle covers
+// more cells than there are cells with entries, it is quicker to look at each of those instead.
+template<typename F>
+void Spatial_grid::for_each_entry_in(Point lower_left, Point upper_right, F found) const
+{
+  int first_column = cell_index(lower_left.x);
+  int last_column = cell_index(upper_right.x);
+  int first_row = cell_index(lower_left.y);
+  int last_row = cell_index(upper_right.y);
+  double num_cells_covered = (double(last_column) - first_column + 1) * (double(last_row) - first_row + 1);
+  if (num_cells_covered > double(cells.size()))
+  {
+    for (auto&& cell : cells)
+    {
+      for (const Entry& entry : cell.second)
+      {
+        found(entry);
+      }
+    }
+    return;
+  }
+  for (long long column = first_column; column <= last_column; column++)
+  {
+    for (long long row = first_row; row <= last_row; row++)
+    {
+      auto cell_it = cells.find(cell_key(int(column), int(row)));
+      if (cell_it == cells.end())
+      {
+        continue;
+      }
+      for (const Entry& entry : cell_it->second)
+      {
+        found(entry);
+      }
+    }
+  }
+}
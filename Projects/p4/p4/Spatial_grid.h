@@ -0,0 +1,65 @@
+#ifndef SPATIAL_GRID_H
+#define SPATIAL_GRID_H
+
+#include "Geometry.h"
+#include <unordered_map>
+#include <vector>
+
+class Sim_object;
+
+/***** Spatial_grid Class *****/
+/* A Spatial_grid keeps track of where Sim_objects are by dividing the plane into square
+ cells of a fixed size and keeping a list of the objects in each cell, along with their
+ locations. Only the cells that have objects in them are stored, in a hash table, so the
+ plane is unbounded. A query looks only at the cells that overlap the area asked about,
+ and then checks each object in them against the area exactly, so its cost depends on how
+ many objects are nearby rather than on how many there are in all. The grid does not own the
+ objects; whoever adds an object must tell the grid whenever it moves, and remove it before
+ it is destroyed. The objects found by a query are in no particular order.
+ */
+
+class Spatial_grid {
+public:
+  // the cell size must be positive
+  explicit Spatial_grid(double cell_size_);
+
+  // Add the object at the location, or move it there if it is already in the grid.
+  void set_location(Sim_object *object_ptr, Point location);
+  // Remove the object; nothing happens if it isn't in the grid.
+  void remove(Sim_object *object_ptr);
+
+  // the objects whose distance from the center is no more than the radius
+  std::vector<Sim_object*> objects_within(Point center, double radius) const;
+  // the objects inside the rectangle with the supplied corners, or on its edges
+  std::vector<Sim_object*> objects_in_rect(Point lower_left, Point upper_right) const;
+
+  // the number of objects in the grid
+  int size() const
+  {
+    return int(cells_by_object.size());
+  }
+
+private:
+  struct Entry {
+    Sim_object *object_ptr;
+    Point location;
+  };
+  typedef long long Cell_key_t;
+
+  double cell_size;
+  std::unordered_map<Cell_key_t, std::vector<Entry>> cells;
+  std::unordered_map<Sim_object*, Cell_key_t> cells_by_object;
+
+  // the index of the column or row of cells a coordinate is in
+  int cell_index(double coordinate) const;
+  // the key of the cell in a column and row
+  static Cell_key_t cell_key(int column, int row);
+  // remove the object's entry from the cell
+  void remove_entry(Cell_key_t key, Sim_object *object_ptr);
+  // Call found for each entry in the cells that overlap the rectangle, visiting each
+  // cell with an entry at most once.
+  template<typename F>
+  void for_each_entry_in(Point lower_left, Point upper_right, F found) const;
+};
+
+#endif
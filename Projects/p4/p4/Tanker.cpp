@@ -11,8 +11,10 @@
 #include "Model.h"
 #include "Geometry.h"
 #include "Utility.h"
+#include "Logger.h"
 #include <string>
 #include <iostream>
+#include <vector>
 #include <cassert>
 
 using namespace std;
@@ -32,13 +34,13 @@ Ship(name_, position_, TANKER_INIT_FUEL, TANKER_MAX_SPEED, TANKER_FUEL_CONSUMPTI
 load_dest(nullptr), unload_dest(nullptr), cargo(TANKER_INIT_CARGO), cargo_capacity(TANKER_CARGO_CAPACITY),
 tanker_state(State_tanker::NO_CARGO_DEST)
 {
-  cout << "Tanker " << get_name() << " constructed" << endl;
+  Log_line(LOG_LIFECYCLE, LOG_DETAILS) << "Tanker " << get_name() << " constructed";
 }
 
 // output destructor message
 Tanker::~Tanker()
 {
-  cout << "Tanker " << get_name() << " destructed" << endl;
+  Log_line(LOG_LIFECYCLE, LOG_DETAILS) << "Tanker " << get_name() << " destructed";
 }
 
 // This class overrides these Ship functions so that it can check if this Tanker has assigned cargo destinations.
@@ -65,7 +67,7 @@ void Tanker::set_load_destination(Island *dest)
   if (tanker_state != State_tanker::NO_CARGO_DEST) throw Error(TANKER_HAS_DEST_MSG);
   if (unload_dest == dest) throw Error(CARGO_DEST_SAME_MSG);
   load_dest = dest;
-  cout << get_name() << " will load at " << dest->get_name() << endl;
+  Log_line(LOG_CARGO, LOG_EVENTS) << get_name() << " will load at " << dest->get_name();
   if (unload_dest != nullptr) start_cycle();
 }
 
@@ -75,7 +77,7 @@ void Tanker::set_unload_destination(Island *dest)
   if (tanker_state != State_tanker::NO_CARGO_DEST) throw Error(TANKER_HAS_DEST_MSG);
   if (load_dest == dest) throw Error(CARGO_DEST_SAME_MSG);
   unload_dest = dest;
-  cout << get_name() << " will unload at " << dest->get_name() << endl;
+  Log_line(LOG_CARGO, LOG_EVENTS) << get_name() << " will unload at " << dest->get_name();
   if (load_dest != nullptr) start_cycle();
 }
 
@@ -119,7 +121,7 @@ void Tanker::update()
         return;
       }
       cargo += load_dest->provide_fuel(cargo_needed);
-      cout << get_name() << " now has " << cargo << " of cargo" << endl;
+      Log_line(LOG_CARGO, LOG_EVENTS) << get_name() << " now has " << cargo << " of cargo";
       return;
     case State_tanker::UNLOADING:
       if (cargo == 0)
@@ -134,6 +136,30 @@ void Tanker::update()
   }
 }
 
+// loading, unloading, docking and ending the cycle are not routine; otherwise the Ship decides
+int Tanker::get_num_routine_updates() const
+{
+  if (!can_move()) return 0;
+  switch(tanker_state)
+  {
+    case State_tanker::NO_CARGO_DEST:
+      return Ship::get_num_routine_updates();
+    case State_tanker::MOVING_TO_LOAD:
+    case State_tanker::MOVING_TO_UNLOAD:
+      return is_moving() ? Ship::get_num_routine_updates() : 0;
+    case State_tanker::LOADING:
+    case State_tanker::UNLOADING:
+      return 0;
+  }
+  return 0;
+}
+
+void Tanker::add_partners(vector<Sim_object*>& partners) const
+{
+  if (load_dest) partners.push_back(load_dest);
+  if (unload_dest) partners.push_back(unload_dest);
+}
+
 void Tanker::describe() const
 {
   cout << "\nTanker ";
@@ -209,5 +235,5 @@ void Tanker::end_cycle()
 {
   load_dest = unload_dest = nullptr;
   tanker_state = State_tanker::NO_CARGO_DEST;
-  cout << get_name() << " now has no cargo destinations" << endl;
+  Log_line(LOG_CARGO, LOG_EVENTS) << get_name() << " now has no cargo destinations";
 }
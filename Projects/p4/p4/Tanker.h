@@ -4,6 +4,7 @@
 #include "Ship.h"
 #include "Geometry.h"
 #include <string>
+#include <vector>
 
 /*
  A Tanker is a ship with a large cargo capacity for fuel.
@@ -46,6 +47,11 @@ public:
   
   void update() override;
   
+  // loading, unloading, docking and ending the cycle are not routine; otherwise the Ship decides
+  int get_num_routine_updates() const override;
+  
+  void add_partners(std::vector<Sim_object*>& partners) const override;
+  
   void describe() const override;
   
 private:
@@ -0,0 +1,143 @@
+#include "Thread_pool.h"
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <cassert>
+
+using namespace std;
+
+// Start the threads; num_threads_ counts the calling thread, so 1 starts none.
+Thread_pool::Thread_pool(int num_threads_) :
+num_threads(num_threads_), task_ptr(nullptr), chunks_left(0), generation(0), stopping(false)
+{
+  assert(num_threads >= 1);
+  for (int i = 0; i < num_threads; i++)
+  {
+    queues.emplace_back(new Chunk_queue);
+  }
+  for (int i = 1; i < num_threads; i++)
+  {
+    workers.emplace_back(&Thread_pool::worker_loop, this, i);
+  }
+}
+
+// Tell the workers to finish, then wait for them.
+Thread_pool::~Thread_pool()
+{
+  {
+    lock_guard<mutex> lock(state_mutex);
+    stopping = true;
+  }
+  work_available.notify_all();
+  for (thread& worker : workers)
+  {
+    worker.join();
+  }
+}
+
+// Deal the chunks out to the threads' queues in turn, wake the workers, do chunks on
+// this thread until there are none left to take, then wait for the workers to finish theirs.
+// The task is set before any chunk is queued, since a worker still finishing the last
+// call may find the new chunks before it is woken for them.
+void Thread_pool::parallel_for(int num_indexes, int grain, const function<void(int, int)>& task)
+{
+  assert(grain >= 1);
+  if (num_indexes <= 0)
+  {
+    return;
+  }
+  int num_chunks = (num_indexes + grain - 1) / grain;
+  if (num_threads == 1 || num_chunks == 1)
+  {
+    task(0, num_indexes);
+    return;
+  }
+  {
+    lock_guard<mutex> lock(state_mutex);
+    task_ptr = &task;
+    chunks_left = num_chunks;
+  }
+  for (int chunk = 0; chunk < num_chunks; chunk++)
+  {
+    int begin = chunk * grain;
+    int end = begin + grain < num_indexes ? begin + grain : num_indexes;
+    Chunk_queue& queue = *queues[chunk % num_threads];
+    lock_guard<mutex> lock(queue.mutex);
+    queue.chunks.emplace_back(begin, end);
+  }
+  {
+    lock_guard<mutex> lock(state_mutex);
+    ++generation;
+  }
+  work_available.notify_all();
+  run_chunks(0);
+  unique_lock<mutex> lock(state_mutex);
+  work_done.wait(lock, [this]{return chunks_left == 0;});
+}
+
+// what each worker thread runs
+void Thread_pool::worker_loop(int thread_index)
+{
+  unsigned long seen_generation = 0;
+  while (true)
+  {
+    {
+      unique_lock<mutex> lock(state_mutex);
+      work_available.wait(lock, [this, seen_generation]{return stopping || generation != seen_generation;});
+      if (stopping)
+      {
+        return;
+      }
+      seen_generation = generation;
+    }
+    run_chunks(thread_index);
+  }
+}
+
+// Run chunks, taking them from this thread's queue and stealing from the others,
+// until there are none left to take.
+void Thread_pool::run_chunks(int thread_index)
+{
+  Chunk_t chunk;
+  while (take_chunk(thread_index, chunk))
+  {
+    (*task_ptr)(chunk.first, chunk.second);
+    if (--chunks_left == 0)
+    {
+      // the lock makes sure the caller is either not yet waiting or already woken
+      lock_guard<mutex> lock(state_mutex);
+      work_done.notify_all();
+    }
+  }
+}
+
+// take a chunk from the back of this thread's queue, or the front of another's
+bool Thread_pool::take_chunk(int thread_index, Chunk_t& chunk)
+{
+  {
+    Chunk_queue& own = *queues[thread_index];
+    lock_guard<mutex> lock(own.mutex);
+    if (!own.chunks.empty())
+    {
+      chunk = own.chunks.back();
+      own.chunks.pop_back();
+      return true;
+    }
+  }
+  for (int i = 1; i < num_threads; i++)
+  {
+    Chunk_queue& other = *queues[(thread_index + i) % num_threads];
+    lock_guard<mutex> lock(other.mutex);
+    if (!other.chunks.empty())
+    {
+      chunk = other.chunks.front();
+      other.chunks.pop_front();
+      return true;
+    }
+  }
+  return false;
+}
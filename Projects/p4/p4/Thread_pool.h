@@ -0,0 +1,79 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+/***** Thread_pool Class *****/
+/* A Thread_pool runs the chunks of a range of indexes on a fixed set of threads, one of which
+ is the thread that asks for the work to be done. Each thread has its own queue of chunks;
+ it takes chunks from the back of its own queue, and when that is empty it steals them from
+ the front of the others' queues, so a thread that finishes early helps the rest instead of
+ waiting. Nothing is promised about which thread runs which chunk or in what order, so the
+ chunks must not depend on each other. The workers wait, without using the processor,
+ while there is nothing to do.
+ */
+
+class Thread_pool {
+public:
+  // Start the threads; num_threads_ counts the calling thread, so 1 starts none.
+  explicit Thread_pool(int num_threads_);
+
+  // Tell the workers to finish, then wait for them.
+  ~Thread_pool();
+
+  int get_num_threads() const
+  {
+    return num_threads;
+  }
+
+  // Call task(begin, end) for consecutive chunks of at most grain indexes that together cover
+  // [0, num_indexes), on all of the threads, and return when every chunk has been done.
+  // The task must not throw an exception.
+  void parallel_for(int num_indexes, int grain, const std::function<void(int, int)>& task);
+
+  // disallow copy/move construction or assignment
+  Thread_pool(const Thread_pool&) = delete;
+  Thread_pool& operator=(const Thread_pool&) = delete;
+
+private:
+  typedef std::pair<int, int> Chunk_t;
+
+  // a queue of chunks for one thread, which the other threads may steal from
+  struct Chunk_queue {
+    std::mutex mutex;
+    std::deque<Chunk_t> chunks;
+  };
+
+  int num_threads;
+  std::vector<std::unique_ptr<Chunk_queue>> queues;     // indexed by thread; 0 is the caller
+  std::vector<std::thread> workers;
+
+  // the work being done, and how many of its chunks are left
+  const std::function<void(int, int)>* task_ptr;
+  std::atomic<int> chunks_left;
+
+  // the workers are woken for each new parallel_for, counted by generation
+  std::mutex state_mutex;
+  std::condition_variable work_available;
+  std::condition_variable work_done;
+  unsigned long generation;
+  bool stopping;
+
+  // what each worker thread runs
+  void worker_loop(int thread_index);
+  // Run chunks, taking them from this thread's queue and stealing from the others,
+  // until there are none left to take.
+  void run_chunks(int thread_index);
+  // take a chunk from the back of this thread's queue, or the front of another's
+  bool take_chunk(int thread_index, Chunk_t& chunk);
+};
+
+#endif
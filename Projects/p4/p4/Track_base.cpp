@@ -1,7 +1,7 @@
 #include "Track_base.h"
 #include "Navigation.h"
+#include "Logger.h"
 
-#include <iostream>
 #include <cmath>
 
 using namespace std;
@@ -10,23 +10,23 @@ using namespace std;
 
 Track_base::Track_base() : altitude(0.)
 {
-	std::cout << "Track_base constructed" << std::endl;
+	Log_line(LOG_LIFECYCLE, LOG_DETAILS) << "Track_base constructed";
 }
 
 Track_base::Track_base(Point position_) : position(position_), altitude(0.)
 {
-	std::cout << "Track_base constructed" << std::endl;
+	Log_line(LOG_LIFECYCLE, LOG_DETAILS) << "Track_base constructed";
 }
 
 Track_base::Track_base(Point position_, Course_speed course_speed_, double altitude_) :
 		position(position_), course_speed(course_speed_), altitude(altitude_)
 {
-	std::cout << "Track_base constructed" << std::endl;
+	Log_line(LOG_LIFECYCLE, LOG_DETAILS) << "Track_base constructed";
 }
 
 Track_base::~Track_base()
 {
-	std::cout << "Track_base destructed" << std::endl;
+	Log_line(LOG_LIFECYCLE, LOG_DETAILS) << "Track_base destructed";
 }
 
 
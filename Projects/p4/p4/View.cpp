@@ -1,6 +1,7 @@
 #include "View.h"
 #include "Geometry.h"
 #include "Utility.h"
+#include "Logger.h"
 #include <string>
 #include <iostream>
 #include <iomanip>
@@ -25,12 +26,12 @@ const int VIEW_AXIS_LABEL_MAX = 4;
 View::View()
 {
   set_defaults();
-  cout << "View constructed" << endl;
+  Log_line(LOG_LIFECYCLE, LOG_DETAILS) << "View constructed";
 }
 // outputs destructor message
 View::~View()
 {
-  cout << "View destructed" << endl;
+  Log_line(LOG_LIFECYCLE, LOG_DETAILS) << "View destructed";
 }
 
 // Save the supplied name and location for future use in a draw() call
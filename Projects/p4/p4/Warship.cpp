@@ -9,8 +9,10 @@
 #include "Warship.h"
 #include "Ship.h"
 #include "Utility.h"
+#include "Logger.h"
 #include <string>
 #include <iostream>
+#include <vector>
 
 using namespace std;
 
@@ -21,14 +23,14 @@ Warship::Warship(const string& name_, Point position_, double fuel_capacity_,
 Ship(name_, position_, fuel_capacity_, maximum_speed_, fuel_consumption_, resistance_),
 firepower(firepower_), max_range(maximum_range_), warship_state(State_warship::NOT_ATTACKING), target(nullptr)
 {
-  cout << "Warship " << get_name() << " constructed" << endl;
+  Log_line(LOG_LIFECYCLE, LOG_DETAILS) << "Warship " << get_name() << " constructed";
 }
 
 // a pure virtual function to mark this as an abstract class,
 // but defined anyway to output destructor message
 Warship::~Warship()
 {
-  cout << "Warship " << get_name() << " destructed" << endl;
+  Log_line(LOG_LIFECYCLE, LOG_DETAILS) << "Warship " << get_name() << " destructed";
 }
 
 // perform warship-specific behavior
@@ -42,10 +44,22 @@ void Warship::update()
   }
   else
   {
-    cout << get_name() << " is attacking" << endl;
+    Log_line(LOG_COMBAT, LOG_DETAILS) << get_name() << " is attacking";
   }
 }
 
+// attacking is not routine; otherwise the Ship decides
+int Warship::get_num_routine_updates() const
+{
+  if (warship_state == State_warship::ATTACKING) return 0;
+  return Ship::get_num_routine_updates();
+}
+
+void Warship::add_partners(vector<Sim_object*>& partners) const
+{
+  if (target) partners.push_back(target);
+}
+
 // Warships will act on an attack and stop_attack command
 
 // will	throw Error("Cannot attack!") if not Afloat
@@ -58,7 +72,7 @@ void Warship::attack(Ship* target_ptr_)
   if (target_ptr_ == target) throw Error("Already attacking this target!");
   target = target_ptr_;
   warship_state = State_warship::ATTACKING;
-  cout << get_name() << " will attack " << target->get_name() << endl;
+  Log_line(LOG_COMBAT, LOG_EVENTS) << get_name() << " will attack " << target->get_name();
 }
 
 // will throw Error("Was not attacking!") if not Attacking
@@ -67,7 +81,7 @@ void Warship::stop_attack()
   if (warship_state != State_warship::ATTACKING) throw Error("Was not attacking!");
   warship_state = State_warship::NOT_ATTACKING;
   target = nullptr;
-  cout << get_name() << " stopping attack" << endl;
+  Log_line(LOG_COMBAT, LOG_EVENTS) << get_name() << " stopping attack";
 }
 
 void Warship::describe() const
@@ -82,6 +96,6 @@ void Warship::describe() const
 // fire at the current target
 void Warship::fire_at_target()
 {
-  cout << get_name() << " fires" << endl;
+  Log_line(LOG_COMBAT, LOG_EVENTS) << get_name() << " fires";
   target->receive_hit(firepower, this);
 }
@@ -13,6 +13,7 @@
 #include "Geometry.h"
 #include "Navigation.h"
 #include <string>
+#include <vector>
 
 /* Warship class
  A Warship is a ship with firepower and range member variables, and some services for
@@ -36,6 +37,11 @@ public:
   // perform warship-specific behavior
   void update() override;
   
+  // attacking is not routine; otherwise the Ship decides
+  int get_num_routine_updates() const override;
+  
+  void add_partners(std::vector<Sim_object*>& partners) const override;
+  
   // Warships will act on an attack and stop_attack command
   
   // will	throw Error("Cannot attack!") if not Afloat
@@ -0,0 +1,160 @@
+/*
+ This is a benchmark of the Collision_monitor, which finds the pairs of ships whose closest
+ point of approach (CPA) is within a range and a time horizon.
+
+ For each number of ships, it scatters Cruisers at random over a square sized so that there
+ is one ship to every 100 square nm, and sets each on a random course at a random speed up
+ to 20 nm/hr. Then, for a number of ticks, it updates the ships and the monitor, with the
+ warning range of 1 nm and time horizon of 3 hr that Model starts with, and reports the
+ average number of candidate pairs whose CPA was computed, out of all of the pairs there
+ are, the number of warnings, and the time the monitor took per tick.
+
+ For the smallest number of ships, it also checks the warnings of the first tick against
+ all of the pairs, using compute_CPA. The two may disagree about a pair whose CPA range or
+ time is within rounding error of the limits, so those pairs aren't counted as differences.
+
+ Build it with "make collisionbenchexe" in the p4 directory.
+ Run it, optionally with the number of ticks, e.g. "collisionbenchexe 10".
+ By default there are 10 ticks, for 10000, 30000 and 100000 ships.
+ */
+#include "../Collision_monitor.h"
+#include "../Model.h"
+#include "../Logger.h"
+#include "../Ship.h"
+#include "../Ship_factory.h"
+#include "../Geometry.h"
+#include "../Navigation.h"
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <algorithm>
+#include <random>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+using namespace std;
+
+static const int ship_counts[] = {10000, 30000, 100000};
+static const double area_per_ship = 100.;
+static const double warning_range = 1.;
+static const double time_horizon = 3.;
+// pairs this close to the limits may be judged either way
+static const double tolerance = 1e-6;
+
+// seconds since the supplied start time
+static double elapsed_s(chrono::steady_clock::time_point start) {
+  return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+// Count the pairs of ships that compute_CPA puts within the limits and that the monitor
+// did not warn about, or the other way around, leaving out the pairs too close to call.
+static int count_differences(const vector<const Ship*>& ships,
+                             const vector<Collision_monitor::Warning>& warnings) {
+  unordered_map<string, long long> indexes;
+  for (size_t i = 0; i < ships.size(); i++) {
+    indexes[ships[i]->get_name()] = (long long)i;
+  }
+  // each pair is kept as one number, with the lower index first
+  long long num_ships = (long long)ships.size();
+  unordered_set<long long> warned;
+  for (const Collision_monitor::Warning& warning : warnings) {
+    long long first = indexes[warning.first_name], second = indexes[warning.second_name];
+    warned.insert(min(first, second) * num_ships + max(first, second));
+  }
+  int num_different = 0;
+  for (long long i = 0; i < num_ships; i++) {
+    for (long long j = i + 1; j < num_ships; j++) {
+      double time;
+      Compass_position cpa = compute_CPA(ships[i]->get_course_speed(), ships[j]->get_course_speed(),
+                                         Compass_position(ships[i]->get_location(), ships[j]->get_location()),
+                                         time);
+      double range = cpa.range;
+      // compute_CPA can't say where ships with no relative motion are closest
+      if (std::isnan(time)) {
+        time = 0.;
+        range = cartesian_distance(ships[i]->get_location(), ships[j]->get_location());
+      }
+      bool should_warn = range <= warning_range && time <= time_horizon;
+      bool too_close_to_call = fabs(range - warning_range) < tolerance ||
+      fabs(time - time_horizon) < tolerance;
+      bool did_warn = warned.count(i * num_ships + j) > 0;
+      num_different += should_warn != did_warn && !too_close_to_call;
+    }
+  }
+  return num_different;
+}
+
+int main(int argc, char* argv[]) {
+  int num_ticks = argc > 1 ? atoi(argv[1]) : 10;
+  mt19937 generator(12345);
+
+  // the ships need a Model to tell about their locations; their output goes nowhere
+  streambuf* cout_buf = cout.rdbuf(nullptr);
+  g_Model_ptr = new Model;
+  vector<string> report;
+  bool all_agree = true;
+  for (int num_ships : ship_counts) {
+    double side = sqrt(num_ships * area_per_ship);
+    uniform_real_distribution<double> coordinate(0., side), course(0., 360.), speed(0., 20.);
+    vector<Ship*> ships;
+    vector<const Ship*> const_ships;
+    for (int i = 0; i < num_ships; i++) {
+      double x = coordinate(generator);
+      double y = coordinate(generator);
+      ships.push_back(create_ship("C" + to_string(i), "Cruiser", Point(x, y)));
+      double c = course(generator);
+      ships.back()->set_course_and_speed(c, speed(generator));
+      const_ships.push_back(ships.back());
+    }
+    Collision_monitor monitor(warning_range, time_horizon);
+    double monitor_s = 0.;
+    long long num_candidates = 0, num_warnings = 0;
+    int num_different = 0;
+    for (int tick = 0; tick < num_ticks; tick++) {
+      auto start = chrono::steady_clock::now();
+      monitor.update(const_ships);
+      monitor_s += elapsed_s(start);
+      num_candidates += monitor.get_num_candidates();
+      num_warnings += monitor.get_warnings().size();
+      if (tick == 0 && num_ships == ship_counts[0]) {
+        num_different = count_differences(const_ships, monitor.get_warnings());
+      }
+      for (Ship* ship_ptr : ships) {
+        ship_ptr->update();
+      }
+    }
+    for (Ship* ship_ptr : ships) {
+      delete ship_ptr;
+    }
+    ostringstream os;
+    os << fixed << setprecision(1);
+    os << setw(7) << num_ships << " ships: " << setw(9) << double(num_candidates) / num_ticks
+    << " of " << setw(10) << double(num_ships) * (num_ships - 1) / 2 << " pairs evaluated, "
+    << setw(6) << double(num_warnings) / num_ticks << " warnings, " << setw(7)
+    << monitor_s * 1000 / num_ticks << " ms/tick";
+    if (num_different) {
+      os << ", " << num_different << " pairs differ from compute_CPA";
+      all_agree = false;
+    }
+    report.push_back(os.str());
+  }
+  delete g_Model_ptr;
+  // the records are written on another thread, so they must all be written before cout changes
+  g_Logger.flush();
+  cout.rdbuf(cout_buf);
+  cout.clear();
+
+  for (const string& line : report) {
+    cout << line << endl;
+  }
+  if (!all_agree) {
+    return 1;
+  }
+  cout << "the warnings agree with compute_CPA for every pair checked" << endl;
+  return 0;
+}
@@ -0,0 +1,185 @@
+/*
+ This is a benchmark of updating a large number of Ships, with their steps computed
+ one Ship at a time by Ship::calculate_movement, and computed for all of them at once by
+ a Fleet. It is also the check that the two give exactly the same results.
+
+ It makes two identical sets of Cruisers and Tankers and sends each Ship either to a
+ destination or off on a course, slowly enough that they keep moving for a while; some
+ arrive, some run out of fuel, and the rest are still moving at the end. Every ten ticks,
+ the Ships that have arrived are sent on somewhere else. The Ships of one set are
+ updated as they were before there were Fleets; those of the other are in a Fleet, which
+ computes their steps each tick before they are updated, as Model::update does, on a
+ Thread_pool of 1, 2, 4 and then 8 threads, with a new set of Ships each time. The ticks
+ per second of each are reported, along with how long computing the steps took in all.
+ After each run, the position, course, speed, fuel and state of every Ship are compared
+ with those of the same Ship in the scalar set, along with the number of Ships moving
+ after each tick.
+
+ The Ships' output goes nowhere, but the cost of producing it is still part of an update.
+ Build it with "make fleetbenchexe" in the p4 directory; its ISO -std mode keeps the
+ compiler from contracting a multiply and add in one path but not the other.
+ Run it, optionally with the number of Ships and ticks, e.g. "fleetbenchexe 100000 50".
+ By default there are 100000 Ships and 50 ticks.
+ */
+#include "../Model.h"
+#include "../Logger.h"
+#include "../Fleet.h"
+#include "../Ship.h"
+#include "../Ship_factory.h"
+#include "../Thread_pool.h"
+#include "../Geometry.h"
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+using namespace std;
+
+// the Ships that have arrived are sent somewhere else this often
+static const int resend_interval = 10;
+// the numbers of threads the Fleet's steps are computed on
+static const int thread_counts[] = {1, 2, 4, 8};
+
+// seconds since the supplied start time
+static double elapsed_s(chrono::steady_clock::time_point start) {
+  return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+// Send a Ship off using the next numbers from the generator, to a destination for
+// an even number and on a course for an odd one, slowly enough to last a while.
+static void send_ship(Ship* ship_ptr, mt19937& generator) {
+  uniform_real_distribution<double> offset(-60., 60.), course(0., 360.), speed(0.1, 2.);
+  if (generator() % 2 == 0) {
+    Point location = ship_ptr->get_location();
+    double x = location.x + offset(generator);
+    double y = location.y + offset(generator);
+    ship_ptr->set_destination_position_and_speed(Point(x, y), speed(generator));
+  }
+  else {
+    double c = course(generator);
+    ship_ptr->set_course_and_speed(c, speed(generator));
+  }
+}
+
+// Make the Ships, the same ones for the same seed, and start them moving.
+static vector<Ship*> make_ships(int num_ships, unsigned seed) {
+  mt19937 generator(seed);
+  uniform_real_distribution<double> coordinate(-1000., 1000.);
+  vector<Ship*> ships;
+  ships.reserve(num_ships);
+  for (int i = 0; i < num_ships; i++) {
+    double x = coordinate(generator);
+    double y = coordinate(generator);
+    ships.push_back(create_ship("S" + to_string(i), i % 2 ? "Tanker" : "Cruiser", Point(x, y)));
+    send_ship(ships.back(), generator);
+  }
+  return ships;
+}
+
+// Update the Ships for a number of ticks, computing the steps first if there is a Fleet,
+// and return the number moving after each tick. The generator sends the Ships
+// that have arrived on again. The time spent computing steps is added to steps_s.
+static vector<int> run(vector<Ship*>& ships, Fleet* fleet_ptr, Thread_pool* pool_ptr,
+                       int num_ticks, mt19937& generator, double& steps_s) {
+  vector<int> num_moving;
+  for (int tick = 1; tick <= num_ticks; tick++) {
+    if (fleet_ptr) {
+      auto start = chrono::steady_clock::now();
+      fleet_ptr->compute_steps(pool_ptr);
+      steps_s += elapsed_s(start);
+    }
+    int moving = 0;
+    for (Ship* ship_ptr : ships) {
+      ship_ptr->update();
+      moving += ship_ptr->is_moving();
+    }
+    num_moving.push_back(moving);
+    if (tick % resend_interval == 0) {
+      for (Ship* ship_ptr : ships) {
+        if (ship_ptr->can_move() && !ship_ptr->is_moving()) {
+          send_ship(ship_ptr, generator);
+        }
+      }
+    }
+  }
+  return num_moving;
+}
+
+// whether two Ships are in exactly the same state
+static bool same_state(const Ship* lhs, const Ship* rhs) {
+  return lhs->get_location() == rhs->get_location() && lhs->get_course() == rhs->get_course()
+  && lhs->get_speed() == rhs->get_speed() && lhs->get_fuel() == rhs->get_fuel()
+  && lhs->is_moving() == rhs->is_moving() && lhs->can_move() == rhs->can_move();
+}
+
+int main(int argc, char* argv[]) {
+  int num_ships = argc > 1 ? atoi(argv[1]) : 100000;
+  int num_ticks = argc > 2 ? atoi(argv[2]) : 50;
+  const unsigned seed = 12345;
+
+  // the Ships need a Model to tell about their locations; nothing is printed until the end
+  streambuf* cout_buf = cout.rdbuf(nullptr);
+  g_Model_ptr = new Model;
+
+  vector<Ship*> scalar_ships = make_ships(num_ships, seed);
+  mt19937 scalar_generator(seed + 1);
+  double no_steps_s = 0;
+  auto start = chrono::steady_clock::now();
+  vector<int> scalar_moving = run(scalar_ships, nullptr, nullptr, num_ticks, scalar_generator,
+                                  no_steps_s);
+  double scalar_s = elapsed_s(start);
+
+  vector<double> fleet_s, steps_s;
+  vector<int> num_different;
+  for (int num_threads : thread_counts) {
+    Thread_pool pool(num_threads);
+    Fleet fleet;
+    vector<Ship*> fleet_ships = make_ships(num_ships, seed);
+    for (Ship* ship_ptr : fleet_ships) {
+      ship_ptr->join_fleet(&fleet);
+    }
+    mt19937 fleet_generator(seed + 1);
+    steps_s.push_back(0);
+    start = chrono::steady_clock::now();
+    vector<int> fleet_moving = run(fleet_ships, &fleet, &pool, num_ticks, fleet_generator,
+                                   steps_s.back());
+    fleet_s.push_back(elapsed_s(start));
+    int different = fleet_moving == scalar_moving ? 0 : num_ships;
+    for (int i = 0; i < num_ships; i++) {
+      different += !same_state(scalar_ships[i], fleet_ships[i]);
+      delete fleet_ships[i];
+    }
+    num_different.push_back(different);
+  }
+  int still_moving = scalar_moving.back();
+  for (Ship* ship_ptr : scalar_ships) {
+    delete ship_ptr;
+  }
+  delete g_Model_ptr;
+  // the records are written on another thread, so they must all be written before cout changes
+  g_Logger.flush();
+  cout.rdbuf(cout_buf);
+  cout.clear();
+
+  cout << fixed << setprecision(1);
+  cout << num_ships << " ships, " << num_ticks << " ticks, " << still_moving
+  << " still moving at the end" << endl;
+  cout << setw(20) << "scalar" << setw(12) << num_ticks / scalar_s << " ticks/s" << endl;
+  bool all_agree = true;
+  for (size_t i = 0; i < fleet_s.size(); i++) {
+    cout << setw(10) << "fleet, " << thread_counts[i] << (thread_counts[i] == 1 ? " thread " : " threads")
+    << setw(12) << num_ticks / fleet_s[i] << " ticks/s, steps took " << steps_s[i] * 1000 << "ms";
+    if (num_different[i]) {
+      cout << ", " << num_different[i] << " ships differ from the scalar update";
+      all_agree = false;
+    }
+    cout << endl;
+  }
+  if (!all_agree) {
+    return 1;
+  }
+  cout << "the scalar and fleet updates agree for every ship" << endl;
+  return 0;
+}
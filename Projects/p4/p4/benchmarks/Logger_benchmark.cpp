@@ -0,0 +1,66 @@
+/*
+ This is a benchmark of logging a record like the one Ship::update writes for each moving
+ ship, "<name> now at (<x>, <y>)", written to cout with endl as it was before there was a
+ Logger, and logged with a Log_line at the details level, where it is written by the
+ Logger's thread, and at the quiet level, where it is not written at all.
+
+ The records go to cout, so run it with the output going to a file or to /dev/null, e.g.
+   loggerbenchexe 1000000 > /dev/null
+ The times are reported on cerr. Build it with "make loggerbenchexe" in the p4 directory.
+ Run it, optionally with the number of records. By default there are 1000000.
+ The Logger time includes waiting at the end until everything has been written.
+ */
+#include "../Logger.h"
+#include "../Geometry.h"
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <cstdlib>
+#include <string>
+#include <vector>
+using namespace std;
+
+// seconds since the supplied start time
+static double elapsed_s(chrono::steady_clock::time_point start) {
+  return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+int main(int argc, char* argv[]) {
+  int num_records = argc > 1 ? atoi(argv[1]) : 1000000;
+  cout.setf(ios::fixed, ios::floatfield);
+  cout.precision(2);
+  vector<string> names;
+  for (int i = 0; i < 1000; i++) {
+    names.push_back("S" + to_string(i));
+  }
+
+  auto start = chrono::steady_clock::now();
+  for (int i = 0; i < num_records; i++) {
+    cout << names[i % names.size()] << " now at " << Point(i * .5, i * .25) << endl;
+  }
+  double cout_s = elapsed_s(start);
+
+  g_Logger.set_level(LOG_DETAILS);
+  start = chrono::steady_clock::now();
+  for (int i = 0; i < num_records; i++) {
+    Log_line(LOG_MOVEMENT, LOG_DETAILS) << names[i % names.size()] << " now at " << Point(i * .5, i * .25);
+  }
+  double logged_s = elapsed_s(start);
+  g_Logger.flush();
+  double written_s = elapsed_s(start);
+
+  g_Logger.set_level(LOG_QUIET);
+  start = chrono::steady_clock::now();
+  for (int i = 0; i < num_records; i++) {
+    Log_line(LOG_MOVEMENT, LOG_DETAILS) << names[i % names.size()] << " now at " << Point(i * .5, i * .25);
+  }
+  double quiet_s = elapsed_s(start);
+
+  cerr << fixed << setprecision(1);
+  cerr << num_records << " records" << endl;
+  cerr << setw(34) << "cout with endl: " << setw(8) << cout_s * 1e9 / num_records << " ns/record" << endl;
+  cerr << setw(34) << "Logger, until logged: " << setw(8) << logged_s * 1e9 / num_records << " ns/record" << endl;
+  cerr << setw(34) << "Logger, until written: " << setw(8) << written_s * 1e9 / num_records << " ns/record" << endl;
+  cerr << setw(34) << "Logger, quiet: " << setw(8) << quiet_s * 1e9 / num_records << " ns/record" << endl;
+  return 0;
+}
@@ -0,0 +1,292 @@
+/*
+ This is a benchmark of whole simulation ticks, run without a Controller or View on
+ scenarios made by a seeded generator, so that the same scenario can be run again later
+ and the results compared.
+
+ A scenario has islands, which produce fuel, Tankers, which carry it between pairs of
+ islands, and Cruisers, which are in pairs: each pair patrols slowly side by side, and at
+ some tick during the run one of them is ordered to attack the other, which fires back;
+ the pairs' attack orders are spread evenly over the run. The generator puts the objects
+ in the Model, along with the ones the Model starts with, then the ticks are run with
+ Model::update, with the logging quiet, as a long run with nobody watching would be.
+ Each scenario is then run again with the ticks between one attack order and the next run
+ by a single Model::advance, which fast-forwards the objects through their routine updates,
+ and the objects' descriptions at the end, to every digit, are checked to be the same.
+
+ For each scenario and each way of running it, it reports the ticks per second, the time
+ per object update (the tick time divided by the number of objects at the start of each tick,
+ or of each advance, which falls as the Cruisers sink), the number of
+ heap allocations per tick, counted by the replacement operator new below, and the peak
+ resident set size of the process so far, which only grows from one scenario to the next.
+
+ The Model tells objects apart by the first two characters of their names, so a scenario
+ can have at most a few thousand objects; the largest standard scenario is near the limit.
+
+ Build it with "make p4benchexe" in the p4 directory.
+ Run it, optionally naming a standard scenario, e.g. "p4benchexe medium",
+ or giving the numbers of islands, Tankers and Cruisers, the ticks, and optionally the seed
+ and number of threads, e.g. "p4benchexe custom 100 500 500 200 7 2".
+ By default all of the standard scenarios are run, on one thread.
+ */
+#include "../Model.h"
+#include "../Island.h"
+#include "../Ship.h"
+#include "../Ship_factory.h"
+#include "../Geometry.h"
+#include "../Logger.h"
+#include "../Utility.h"
+#include <sys/resource.h>
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <new>
+#include <random>
+#include <string>
+#include <vector>
+using namespace std;
+
+// Heap allocations so far, counted by the replacement operator new below.
+static atomic<long> g_allocations(0);
+
+void* operator new(size_t size) {
+  g_allocations.fetch_add(1, memory_order_relaxed);
+  void* ptr = malloc(size ? size : 1);
+  if (!ptr) {
+    throw bad_alloc();
+  }
+  return ptr;
+}
+
+void operator delete(void* ptr) noexcept {
+  free(ptr);
+}
+
+void operator delete(void* ptr, size_t) noexcept {
+  free(ptr);
+}
+
+struct Scenario {
+  string name;
+  int num_islands;
+  int num_tankers;
+  int num_cruisers;
+  int num_ticks;
+  unsigned seed;
+};
+
+// The standard scenarios; change them only by adding new ones, so that results stay comparable.
+static const Scenario standard_scenarios[] = {
+  {"small", 10, 20, 20, 1000, 1},
+  {"medium", 50, 300, 300, 200, 2},
+  {"large", 200, 1700, 1700, 50, 3},
+};
+
+// the area per object, in square nm, and the distances between the objects of a pair, in nm
+static const double area_per_object = 400.;
+static const double min_pair_distance = 5.;
+static const double max_pair_distance = 12.;
+static const double max_patrol_speed = 3.;
+
+// an attack order, given before the update of its tick
+struct Attack_order {
+  int tick;
+  string attacker_name;
+  string target_name;
+};
+
+// Makes names whose first two characters, which are all the Model goes by, are not in use.
+class Name_maker {
+public:
+  string next(const string& kind) {
+    static const string characters =
+    "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789";
+    while (true) {
+      if (next_prefix >= characters.size() * characters.size()) {
+        throw Error("Too many objects for the Model to tell apart!");
+      }
+      string prefix = string(1, characters[next_prefix / characters.size()]) +
+      characters[next_prefix % characters.size()];
+      next_prefix++;
+      if (!g_Model_ptr->is_name_in_use(prefix)) {
+        return prefix + kind;
+      }
+    }
+  }
+
+private:
+  size_t next_prefix = 0;
+};
+
+// a point at a random distance within the pair distances, in a random direction
+static Point near_point(Point center, mt19937& generator) {
+  uniform_real_distribution<double> distance(min_pair_distance, max_pair_distance), angle(0., 360.);
+  double d = distance(generator);
+  double a = to_radians(angle(generator));
+  return Point(center.x + d * cos(a), center.y + d * sin(a));
+}
+
+// Put the scenario's objects in the Model, and return the attack orders, by tick.
+static vector<Attack_order> generate(const Scenario& scenario) {
+  mt19937 generator(scenario.seed);
+  int num_objects = scenario.num_islands + scenario.num_tankers + scenario.num_cruisers;
+  double side = sqrt(num_objects * area_per_object);
+  uniform_real_distribution<double> coordinate(0., side), fuel(500., 2000.), production(10., 200.);
+  uniform_real_distribution<double> course(0., 360.), speed(.5, max_patrol_speed);
+  Name_maker names;
+
+  // the islands come in pairs close enough for a Tanker to go between them on one load of fuel
+  vector<Island*> islands;
+  for (int i = 0; i < scenario.num_islands; i++) {
+    Point position = i % 2 ? near_point(islands.back()->get_location(), generator)
+                           : Point(coordinate(generator), coordinate(generator));
+    islands.push_back(new Island(names.next("Island"), position, fuel(generator), production(generator)));
+    g_Model_ptr->add_island(islands.back());
+  }
+  int num_island_pairs = int(islands.size()) / 2;
+  for (int i = 0; i < scenario.num_tankers && num_island_pairs > 0; i++) {
+    Island* load_island = islands[2 * (i % num_island_pairs) + i / num_island_pairs % 2];
+    Island* unload_island = islands[2 * (i % num_island_pairs) + 1 - i / num_island_pairs % 2];
+    Ship* tanker = create_ship(names.next("Tanker"), "Tanker", load_island->get_location());
+    g_Model_ptr->add_ship(tanker);
+    tanker->set_load_destination(load_island);
+    tanker->set_unload_destination(unload_island);
+  }
+
+  vector<Attack_order> orders;
+  int num_cruiser_pairs = scenario.num_cruisers / 2;
+  for (int i = 0; i < num_cruiser_pairs; i++) {
+    Point target_position(coordinate(generator), coordinate(generator));
+    Ship* target = create_ship(names.next("Cruiser"), "Cruiser", target_position);
+    Ship* attacker = create_ship(names.next("Cruiser"), "Cruiser", near_point(target_position, generator));
+    g_Model_ptr->add_ship(target);
+    g_Model_ptr->add_ship(attacker);
+    double pair_course = course(generator);
+    double pair_speed = speed(generator);
+    target->set_course_and_speed(pair_course, pair_speed);
+    attacker->set_course_and_speed(pair_course, pair_speed);
+    orders.push_back(Attack_order{i * scenario.num_ticks / num_cruiser_pairs, attacker->get_name(),
+                                  target->get_name()});
+  }
+  return orders;
+}
+
+// the peak resident set size of the process so far, in MB
+static double peak_RSS_MB() {
+  rusage usage;
+  getrusage(RUSAGE_SELF, &usage);
+#ifdef __APPLE__
+  return usage.ru_maxrss / (1024. * 1024.);
+#else
+  return usage.ru_maxrss / 1024.;
+#endif
+}
+
+// Generate and run the scenario, and report on it. With fast_forward, the ticks up to the next
+// attack order are run with one Model::advance, otherwise with Model::update for each tick.
+// Return what the objects describe themselves as at the end, to every digit.
+static string run(const Scenario& scenario, int num_threads, bool fast_forward) {
+  g_Model_ptr = new Model;
+  g_Model_ptr->set_num_threads(num_threads);
+  vector<Attack_order> orders = generate(scenario);
+  int initial_objects = g_Model_ptr->get_num_objects();
+
+  size_t next_order = 0;
+  long long object_updates = 0;
+  double update_s = 0.;
+  long allocations = 0;
+  for (int tick = 0; tick < scenario.num_ticks;) {
+    for (; next_order < orders.size() && orders[next_order].tick <= tick; next_order++) {
+      const Attack_order& order = orders[next_order];
+      // either Cruiser may have been sunk, or the attacker may already be firing back
+      if (!g_Model_ptr->is_ship_present(order.attacker_name) || !g_Model_ptr->is_ship_present(order.target_name)) {
+        continue;
+      }
+      try {
+        g_Model_ptr->get_ship_ptr(order.attacker_name)->attack(g_Model_ptr->get_ship_ptr(order.target_name));
+      }
+      catch (Error&) {
+      }
+    }
+    int num_ticks = 1;
+    if (fast_forward) {
+      num_ticks = (next_order < orders.size() ? orders[next_order].tick : scenario.num_ticks) - tick;
+    }
+    object_updates += (long long)g_Model_ptr->get_num_objects() * num_ticks;
+    long allocations_before = g_allocations.load(memory_order_relaxed);
+    auto start = chrono::steady_clock::now();
+    if (fast_forward) {
+      g_Model_ptr->advance(num_ticks);
+    }
+    else {
+      g_Model_ptr->update();
+    }
+    update_s += chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    allocations += g_allocations.load(memory_order_relaxed) - allocations_before;
+    tick += num_ticks;
+  }
+  int final_objects = g_Model_ptr->get_num_objects();
+  ostringstream descriptions;
+  streambuf* cout_buf = cout.rdbuf(descriptions.rdbuf());
+  streamsize cout_precision = cout.precision(17);
+  g_Model_ptr->describe();
+  cout.precision(cout_precision);
+  cout.rdbuf(cout_buf);
+  delete g_Model_ptr;
+  g_Model_ptr = nullptr;
+
+  cout << setw(8) << scenario.name << setw(9) << (fast_forward ? "advance" : "update") << setw(9) << initial_objects << setw(9) << final_objects
+  << setw(7) << scenario.num_ticks << setw(12) << scenario.num_ticks / update_s
+  << setw(14) << update_s * 1e9 / object_updates << setw(15) << double(allocations) / scenario.num_ticks
+  << setw(13) << peak_RSS_MB() << endl;
+  return descriptions.str();
+}
+
+int main(int argc, char* argv[]) {
+  g_Logger.set_level(LOG_QUIET);
+  vector<Scenario> scenarios;
+  int num_threads = 1;
+  string first = argc > 1 ? argv[1] : "";
+  if (first == "custom") {
+    if (argc < 6) {
+      cerr << "usage: p4benchexe custom islands tankers cruisers ticks [seed [threads]]" << endl;
+      return 1;
+    }
+    scenarios.push_back(Scenario{"custom", atoi(argv[2]), atoi(argv[3]), atoi(argv[4]), atoi(argv[5]),
+                                 unsigned(argc > 6 ? atoi(argv[6]) : 1)});
+    num_threads = argc > 7 ? atoi(argv[7]) : 1;
+  }
+  else {
+    for (const Scenario& scenario : standard_scenarios) {
+      if (first.empty() || first == scenario.name) {
+        scenarios.push_back(scenario);
+      }
+    }
+    if (scenarios.empty()) {
+      cerr << "unknown scenario " << first << endl;
+      return 1;
+    }
+  }
+
+  cout << fixed << setprecision(1);
+  cout << setw(8) << "scenario" << setw(9) << "by" << setw(9) << "objects" << setw(9) << "at end" << setw(7) << "ticks"
+  << setw(12) << "ticks/s" << setw(14) << "ns/update" << setw(15) << "allocs/tick"
+  << setw(13) << "peak RSS MB" << endl;
+  try {
+    for (const Scenario& scenario : scenarios) {
+      string updated = run(scenario, num_threads, false);
+      if (updated != run(scenario, num_threads, true)) {
+        cerr << "advance did not end with the same results as update for " << scenario.name << endl;
+        return 1;
+      }
+    }
+  }
+  catch (Error& e) {
+    cerr << e.what() << endl;
+    return 1;
+  }
+  return 0;
+}
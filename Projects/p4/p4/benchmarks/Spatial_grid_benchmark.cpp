@@ -0,0 +1,145 @@
+/*
+ This is a benchmark of finding the objects near a point with a Spatial_grid, compared
+ with a linear scan of every object's location, as the brute force range checks do.
+
+ It puts a number of Islands at random in a square 10000 nm on a side, in a grid with the
+ cell size Model uses, and in a plain array. Then it asks for the objects within 20 nm of
+ random points, and for those in random 40 nm squares, of both, and reports the average
+ time a query took, checking that both found the same objects. Last, it moves every
+ object a little, as a tick does for the moving ships, and reports the time per move.
+
+ Build it with "make gridbenchexe" in the p4 directory.
+ Run it, optionally with the number of objects and queries, e.g.
+ "gridbenchexe 100000 10000". By default there are 100000 objects and 10000 queries.
+ */
+#include "../Spatial_grid.h"
+#include "../Island.h"
+#include "../Logger.h"
+#include "../Geometry.h"
+#include <iostream>
+#include <iomanip>
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+using namespace std;
+
+// the size of the square the objects are in, and of the cells, in nm, as in Model
+static const double area_size = 10000.;
+static const double cell_size = 10.;
+static const double query_radius = 20.;
+
+// seconds since the supplied start time
+static double elapsed_s(chrono::steady_clock::time_point start) {
+  return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+int main(int argc, char* argv[]) {
+  int num_objects = argc > 1 ? atoi(argv[1]) : 100000;
+  int num_queries = argc > 2 ? atoi(argv[2]) : 10000;
+  mt19937 generator(12345);
+  uniform_real_distribution<double> coordinate(0., area_size), nudge(-1., 1.);
+
+  // the Islands announce themselves; nothing is printed until the end
+  streambuf* cout_buf = cout.rdbuf(nullptr);
+  Spatial_grid grid(cell_size);
+  vector<pair<Sim_object*, Point>> locations;
+  locations.reserve(num_objects);
+  for (int i = 0; i < num_objects; i++) {
+    double x = coordinate(generator);
+    double y = coordinate(generator);
+    Island* island_ptr = new Island("I" + to_string(i), Point(x, y));
+    grid.set_location(island_ptr, island_ptr->get_location());
+    locations.emplace_back(island_ptr, island_ptr->get_location());
+  }
+  vector<Point> centers;
+  for (int i = 0; i < num_queries; i++) {
+    double x = coordinate(generator);
+    double y = coordinate(generator);
+    centers.push_back(Point(x, y));
+  }
+
+  // answer the queries both ways, keeping the answers to compare
+  vector<vector<Sim_object*>> grid_answers, scan_answers;
+  auto start = chrono::steady_clock::now();
+  for (Point center : centers) {
+    grid_answers.push_back(grid.objects_within(center, query_radius));
+  }
+  double grid_radius_s = elapsed_s(start);
+  start = chrono::steady_clock::now();
+  for (Point center : centers) {
+    vector<Sim_object*> found;
+    for (auto&& location : locations) {
+      if (cartesian_distance(center, location.second) <= query_radius) {
+        found.push_back(location.first);
+      }
+    }
+    scan_answers.push_back(found);
+  }
+  double scan_radius_s = elapsed_s(start);
+
+  start = chrono::steady_clock::now();
+  for (Point center : centers) {
+    grid_answers.push_back(grid.objects_in_rect(Point(center.x - query_radius, center.y - query_radius),
+                                                Point(center.x + query_radius, center.y + query_radius)));
+  }
+  double grid_rect_s = elapsed_s(start);
+  start = chrono::steady_clock::now();
+  for (Point center : centers) {
+    vector<Sim_object*> found;
+    for (auto&& location : locations) {
+      Point p = location.second;
+      if (p.x >= center.x - query_radius && p.x <= center.x + query_radius &&
+          p.y >= center.y - query_radius && p.y <= center.y + query_radius) {
+        found.push_back(location.first);
+      }
+    }
+    scan_answers.push_back(found);
+  }
+  double scan_rect_s = elapsed_s(start);
+
+  long long num_found = 0;
+  int num_different = 0;
+  for (size_t i = 0; i < grid_answers.size(); i++) {
+    sort(grid_answers[i].begin(), grid_answers[i].end());
+    sort(scan_answers[i].begin(), scan_answers[i].end());
+    num_found += grid_answers[i].size();
+    num_different += grid_answers[i] != scan_answers[i];
+  }
+
+  start = chrono::steady_clock::now();
+  for (auto&& location : locations) {
+    double x = location.second.x + nudge(generator);
+    double y = location.second.y + nudge(generator);
+    grid.set_location(location.first, Point(x, y));
+  }
+  double move_s = elapsed_s(start);
+
+  for (auto&& location : locations) {
+    grid.remove(location.first);
+    delete location.first;
+  }
+  // the records are written on another thread, so they must all be written before cout changes
+  g_Logger.flush();
+  cout.rdbuf(cout_buf);
+  cout.clear();
+
+  cout << fixed << setprecision(2);
+  cout << num_objects << " objects, " << num_queries << " queries of each kind, "
+  << double(num_found) / (2 * num_queries) << " objects found per query" << endl;
+  cout << setw(22) << "query" << setw(14) << "grid" << setw(14) << "linear scan" << endl;
+  cout << setw(22) << "objects_within" << setw(12) << grid_radius_s * 1e6 / num_queries << "us"
+  << setw(12) << scan_radius_s * 1e6 / num_queries << "us" << endl;
+  cout << setw(22) << "objects_in_rect" << setw(12) << grid_rect_s * 1e6 / num_queries << "us"
+  << setw(12) << scan_rect_s * 1e6 / num_queries << "us" << endl;
+  cout << setw(22) << "move" << setw(12) << move_s * 1e9 / num_objects << "ns" << endl;
+  if (num_different || grid.size() != 0) {
+    cout << num_different << " queries found different objects in the grid" << endl;
+    return 1;
+  }
+  cout << "the grid and the linear scan found the same objects for every query" << endl;
+  return 0;
+}